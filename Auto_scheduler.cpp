@@ -0,0 +1,565 @@
+#include "Auto_scheduler.h"
+#include "Meeting.h"
+#include "People_directory.h"
+#include "Person.h"
+#include "Room.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+using Clock = chrono::steady_clock;
+
+// string literals
+const char* const bad_budget_message_c = "Time budget must not be negative!";
+
+// the most worker threads the search runs on
+const int max_search_threads_c = 8;
+// the number of (room, time) choices looked at for a request in each step
+const int choices_per_step_c = 16;
+// the number of steps between looks at the clock
+const int steps_per_clock_check_c = 32;
+// one step in this many that leaves fewer requests placed is kept anyway,
+// so that the search can leave a placement no single step improves
+const int worse_step_odds_c = 10;
+
+// the room, time slot or request of a request that is not placed
+const int unplaced_c = -1;
+
+// a meeting to be placed; its people and rooms are positions in the Problem's lists.
+struct Request {
+    string topic;
+    vector<int> people;
+    vector<int> rooms;
+    // the allowed slots that none of the people have a commitment in
+    unsigned int free_slots;
+};
+
+// the requests, and the rooms and people they refer to with the slots each is
+// busy in before any request is placed.
+struct Problem {
+    vector<Request> requests;
+    vector<Room*> rooms;
+    vector<unsigned int> room_busy_slots;
+    vector<Person*> people;
+    vector<unsigned int> person_busy_slots;
+
+    // Returns the slots the request could be placed in the room in on its own.
+    unsigned int open_slots(const Request& request, int room) const
+        { return request.free_slots & ~room_busy_slots[room]; }
+};
+
+// Where each request is placed, if it is, and which request holds each room and
+// person in each slot, so that the requests in the way of a choice are found
+// without looking at the others.
+class Placement {
+public:
+    explicit Placement(const Problem& problem_) :
+        problem(&problem_),
+        request_rooms(problem_.requests.size(), unplaced_c),
+        request_slots(problem_.requests.size(), unplaced_c),
+        room_holders(problem_.rooms.size(), empty_holders()),
+        person_holders(problem_.people.size(), empty_holders()),
+        num_placed(0) {}
+
+    int get_num_placed() const
+        { return num_placed; }
+    bool is_placed(int request) const
+        { return request_rooms[request] != unplaced_c; }
+    int get_room(int request) const
+        { return request_rooms[request]; }
+    int get_slot(int request) const
+        { return request_slots[request]; }
+
+    // Add to the conflicts the placed requests that hold the room, or one of the
+    // request's people, in the slot.
+    void find_conflicts(int request, int room, int slot, vector<int>& conflicts) const;
+
+    // Place the request, which must not be placed, in the room in the slot, which
+    // must be one of its choices and not held by another request; or remove it.
+    void place(int request, int room, int slot);
+    void remove(int request);
+
+    // Place the request at its first choice, in slot then room order, that no
+    // placed request is in the way of. Returns false if there is none.
+    bool place_first_fit(int request);
+
+private:
+    using Holders_t = array<int, num_time_slots_c>;
+
+    static Holders_t empty_holders()
+    {
+        Holders_t holders;
+        holders.fill(unplaced_c);
+        return holders;
+    }
+
+    const Problem* problem;
+    vector<int> request_rooms;
+    vector<int> request_slots;
+    vector<Holders_t> room_holders;
+    vector<Holders_t> person_holders;
+    int num_placed;
+};
+
+void Placement::find_conflicts(int request, int room, int slot, vector<int>& conflicts) const
+{
+    if (room_holders[room][slot] != unplaced_c)
+    {
+        conflicts.push_back(room_holders[room][slot]);
+    }
+    for (int person : problem->requests[request].people)
+    {
+        int holder = person_holders[person][slot];
+        if (holder != unplaced_c && find(conflicts.begin(), conflicts.end(), holder) == conflicts.end())
+        {
+            conflicts.push_back(holder);
+        }
+    }
+}
+
+void Placement::place(int request, int room, int slot)
+{
+    request_rooms[request] = room;
+    request_slots[request] = slot;
+    room_holders[room][slot] = request;
+    for (int person : problem->requests[request].people)
+    {
+        person_holders[person][slot] = request;
+    }
+    ++num_placed;
+}
+
+void Placement::remove(int request)
+{
+    int slot = request_slots[request];
+    room_holders[request_rooms[request]][slot] = unplaced_c;
+    for (int person : problem->requests[request].people)
+    {
+        person_holders[person][slot] = unplaced_c;
+    }
+    request_rooms[request] = unplaced_c;
+    request_slots[request] = unplaced_c;
+    --num_placed;
+}
+
+bool Placement::place_first_fit(int request)
+{
+    const Request& request_data = problem->requests[request];
+    for (int slot = 0; slot < num_time_slots_c; ++slot)
+    {
+        if (!(request_data.free_slots & (1u << slot)) ||
+                any_of(request_data.people.begin(), request_data.people.end(),
+                    [this, slot](int person){ return person_holders[person][slot] != unplaced_c; }))
+        {
+            continue;
+        }
+        for (int room : request_data.rooms)
+        {
+            if (!(problem->room_busy_slots[room] & (1u << slot)) && room_holders[room][slot] == unplaced_c)
+            {
+                place(request, room, slot);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Reads a count from the file that must not be negative.
+static int read_count(ifstream& is)
+{
+    int count;
+    is >> count;
+    file_invalid_data_check(is);
+    if (count < 0)
+    {
+        throw Error(invalid_file_data_message_c);
+    }
+    return count;
+}
+
+// Reads the requests from the file, giving each room and person they refer to a
+// place in the problem's lists.
+static Problem read_problem(ifstream& is, MeetingData& meeting_data)
+{
+    Problem problem;
+    unordered_map<int, int> room_positions;
+    unordered_map<const Person*, int> person_positions;
+    auto room_position = [&problem, &room_positions](Room* room)
+        {
+            auto inserted = room_positions.emplace(room->get_room_number(), static_cast<int>(problem.rooms.size()));
+            if (inserted.second)
+            {
+                problem.rooms.push_back(room);
+                problem.room_busy_slots.push_back(room->get_busy_slots());
+            }
+            return inserted.first->second;
+        };
+    // the positions of all the rooms, for the requests that allow any room
+    vector<int> all_rooms;
+
+    int num_requests = read_count(is);
+    problem.requests.resize(num_requests);
+    for (Request& request : problem.requests)
+    {
+        is >> request.topic;
+        file_invalid_data_check(is);
+
+        int num_times = read_count(is);
+        unsigned int allowed_slots = num_times ? 0 : (1u << num_time_slots_c) - 1;
+        for (int i = 0; i < num_times; ++i)
+        {
+            int time;
+            is >> time;
+            file_invalid_data_check(is);
+            if (!is_meeting_time(time))
+            {
+                throw Error(bad_time_range_message_c);
+            }
+            allowed_slots |= 1u << time_slot(time);
+        }
+
+        int num_rooms = read_count(is);
+        for (int i = 0; i < num_rooms; ++i)
+        {
+            int room_number;
+            is >> room_number;
+            file_invalid_data_check(is);
+            Room* room = meeting_data.rooms.find(room_number);
+            if (!room)
+            {
+                throw Error(no_room_number_message_c);
+            }
+            int position = room_position(room);
+            if (find(request.rooms.begin(), request.rooms.end(), position) == request.rooms.end())
+            {
+                request.rooms.push_back(position);
+            }
+        }
+        if (!num_rooms)
+        {
+            if (all_rooms.empty())
+            {
+                for (Room& room : meeting_data.rooms)
+                {
+                    all_rooms.push_back(room_position(&room));
+                }
+            }
+            request.rooms = all_rooms;
+        }
+
+        int num_participants = read_count(is);
+        unsigned int busy_slots = 0;
+        for (int i = 0; i < num_participants; ++i)
+        {
+            string lastname;
+            is >> lastname;
+            file_invalid_data_check(is);
+            Person* person = meeting_data.people.find(lastname);
+            if (!person)
+            {
+                throw Error(no_person_message_c);
+            }
+            auto inserted = person_positions.emplace(person, static_cast<int>(problem.people.size()));
+            if (inserted.second)
+            {
+                problem.people.push_back(person);
+                problem.person_busy_slots.push_back(person->get_committed_slots());
+            }
+            int position = inserted.first->second;
+            if (find(request.people.begin(), request.people.end(), position) != request.people.end())
+            {
+                throw Error(participant_exists_message_c);
+            }
+            request.people.push_back(position);
+            busy_slots |= problem.person_busy_slots[position];
+        }
+        request.free_slots = allowed_slots & ~busy_slots;
+    }
+    return problem;
+}
+
+// Returns true if the request could be placed if it were the only one.
+static bool is_placeable(const Problem& problem, const Request& request)
+{
+    return any_of(request.rooms.begin(), request.rooms.end(),
+            [&problem, &request](int room){ return problem.open_slots(request, room) != 0; });
+}
+
+// Places the requests with the fewest choices first, each at its first fit.
+static Placement place_greedily(const Problem& problem)
+{
+    vector<int> num_choices(problem.requests.size());
+    vector<int> order(problem.requests.size());
+    for (size_t request = 0; request < problem.requests.size(); ++request)
+    {
+        order[request] = static_cast<int>(request);
+        for (int room : problem.requests[request].rooms)
+        {
+            num_choices[request] += __builtin_popcount(problem.open_slots(problem.requests[request], room));
+        }
+    }
+    // among requests with as many choices, those with more people are harder to place later.
+    stable_sort(order.begin(), order.end(), [&problem, &num_choices](int request1, int request2)
+            {
+                if (num_choices[request1] != num_choices[request2])
+                {
+                    return num_choices[request1] < num_choices[request2];
+                }
+                return problem.requests[request1].people.size() > problem.requests[request2].people.size();
+            });
+    Placement placement(problem);
+    for (int request : order)
+    {
+        if (num_choices[request])
+        {
+            placement.place_first_fit(request);
+        }
+    }
+    return placement;
+}
+
+// Improves the placement until the deadline, or until target requests are placed,
+// and returns the best placement found. Each step takes a request that could be
+// placed but is not, moves it to the choice with the fewest requests in the way,
+// and places those again where they fit.
+static Placement improve_placement(const Problem& problem, const Placement& start, unsigned int seed,
+        Clock::time_point deadline, int target)
+{
+    Placement placement = start;
+    Placement best = start;
+    mt19937 random(seed);
+
+    // the requests that could be placed and are not, and the position of each in the list
+    vector<int> left_out;
+    vector<int> left_out_positions(problem.requests.size(), unplaced_c);
+    auto leave_out = [&left_out, &left_out_positions](int request)
+        {
+            left_out_positions[request] = static_cast<int>(left_out.size());
+            left_out.push_back(request);
+        };
+    auto take_in = [&left_out, &left_out_positions](int request)
+        {
+            int position = left_out_positions[request];
+            left_out[position] = left_out.back();
+            left_out_positions[left_out.back()] = position;
+            left_out.pop_back();
+            left_out_positions[request] = unplaced_c;
+        };
+    for (size_t request = 0; request < problem.requests.size(); ++request)
+    {
+        if (!placement.is_placed(request) && is_placeable(problem, problem.requests[request]))
+        {
+            leave_out(static_cast<int>(request));
+        }
+    }
+
+    // where the requests a step moved were before it, in the order they were moved
+    struct Move {
+        int request;
+        int room;
+        int slot;
+    };
+    vector<Move> moves;
+    vector<int> conflicts, best_conflicts;
+    for (int step = 0; !left_out.empty() && best.get_num_placed() < target; ++step)
+    {
+        if (step % steps_per_clock_check_c == 0 && Clock::now() >= deadline)
+        {
+            break;
+        }
+        int request = left_out[random() % left_out.size()];
+        const Request& request_data = problem.requests[request];
+
+        // look at a few choices, keeping the one with the fewest requests in the way.
+        int best_room = unplaced_c, best_slot = unplaced_c;
+        for (int choice = 0; choice < choices_per_step_c; ++choice)
+        {
+            int room = request_data.rooms[random() % request_data.rooms.size()];
+            unsigned int slots = problem.open_slots(request_data, room);
+            if (!slots)
+            {
+                continue;
+            }
+            // take one of the open slots at random.
+            for (int skip = random() % __builtin_popcount(slots); skip > 0; --skip)
+            {
+                slots &= slots - 1;
+            }
+            int slot = __builtin_ctz(slots);
+            conflicts.clear();
+            placement.find_conflicts(request, room, slot, conflicts);
+            if (best_room == unplaced_c || conflicts.size() < best_conflicts.size())
+            {
+                best_room = room;
+                best_slot = slot;
+                best_conflicts.swap(conflicts);
+                if (best_conflicts.empty())
+                {
+                    break;
+                }
+            }
+        }
+        if (best_room == unplaced_c)
+        {
+            continue;
+        }
+
+        int num_placed_before = placement.get_num_placed();
+        moves.clear();
+        for (int conflict : best_conflicts)
+        {
+            moves.push_back(Move{conflict, placement.get_room(conflict), placement.get_slot(conflict)});
+            placement.remove(conflict);
+            leave_out(conflict);
+        }
+        moves.push_back(Move{request, unplaced_c, unplaced_c});
+        placement.place(request, best_room, best_slot);
+        take_in(request);
+        shuffle(best_conflicts.begin(), best_conflicts.end(), random);
+        for (int conflict : best_conflicts)
+        {
+            if (placement.place_first_fit(conflict))
+            {
+                moves.push_back(Move{conflict, unplaced_c, unplaced_c});
+                take_in(conflict);
+            }
+        }
+
+        if (placement.get_num_placed() < num_placed_before && random() % worse_step_odds_c)
+        {
+            // undo the step, putting back the requests in the reverse of the order they moved.
+            for (auto move_it = moves.rbegin(); move_it != moves.rend(); ++move_it)
+            {
+                if (placement.is_placed(move_it->request))
+                {
+                    placement.remove(move_it->request);
+                    leave_out(move_it->request);
+                }
+                if (move_it->room != unplaced_c)
+                {
+                    placement.place(move_it->request, move_it->room, move_it->slot);
+                    take_in(move_it->request);
+                }
+            }
+        }
+        else if (placement.get_num_placed() > best.get_num_placed())
+        {
+            best = placement;
+        }
+    }
+    return best;
+}
+
+// Adds a meeting for each placed request, with its participants.
+static void add_placed_meetings(const Problem& problem, const Placement& placement)
+{
+    for (size_t request = 0; request < problem.requests.size(); ++request)
+    {
+        if (!placement.is_placed(request))
+        {
+            continue;
+        }
+        const Request& request_data = problem.requests[request];
+        Room* room = problem.rooms[placement.get_room(request)];
+        int time = slot_time(placement.get_slot(request));
+        Meeting* meeting = new Meeting(time, request_data.topic);
+        try{
+            room->add_Meeting(meeting);
+        }
+        catch(...)
+        {
+            delete meeting;
+            throw;
+        }
+        for (int person : request_data.people)
+        {
+            room->add_Meeting_participant(time, problem.people[person]);
+        }
+    }
+}
+
+void cmd_schedule_meetings(MeetingData& meeting_data)
+{
+    string filename;
+    meeting_data.is >> filename;
+    int budget = read_and_check_cmd_int(meeting_data.is);
+    if (budget < 0)
+    {
+        throw Error(bad_budget_message_c);
+    }
+    ifstream is(filename.c_str());
+    if (!is)
+    {
+        throw Error(file_cannot_open_message_c);
+    }
+    // every request is checked before anything is placed.
+    Problem problem = read_problem(is, meeting_data);
+
+    Clock::time_point start_time = Clock::now();
+    Clock::time_point deadline = start_time + chrono::milliseconds(budget);
+    // no more requests can be placed than could be on their own, or than there are
+    // free slots in the rooms they allow.
+    int target = static_cast<int>(count_if(problem.requests.begin(), problem.requests.end(),
+                [&problem](const Request& request){ return is_placeable(problem, request); }));
+    int num_free_slots = 0;
+    for (unsigned int busy_slots : problem.room_busy_slots)
+    {
+        num_free_slots += num_time_slots_c - __builtin_popcount(busy_slots);
+    }
+    target = min(target, num_free_slots);
+    Placement greedy = place_greedily(problem);
+    Placement best = greedy;
+    int num_threads = 0;
+    if (budget > 0 && greedy.get_num_placed() < target)
+    {
+        num_threads = min(max(1, static_cast<int>(thread::hardware_concurrency())), max_search_threads_c);
+        // each thread searches from the greedy placement along its own random path.
+        vector<Placement> results(num_threads, greedy);
+        vector<thread> threads;
+        for (int i = 0; i < num_threads; ++i)
+        {
+            threads.emplace_back([&problem, &greedy, &results, i, deadline, target]
+                    { results[i] = improve_placement(problem, greedy, i + 1, deadline, target); });
+        }
+        for (thread& search_thread : threads)
+        {
+            search_thread.join();
+        }
+        for (const Placement& result : results)
+        {
+            if (result.get_num_placed() > best.get_num_placed())
+            {
+                best = result;
+            }
+        }
+    }
+    long long elapsed = chrono::duration_cast<chrono::milliseconds>(Clock::now() - start_time).count();
+
+    add_placed_meetings(problem, best);
+
+    meeting_data.os << "Scheduled " << best.get_num_placed() << " of " << problem.requests.size()
+        << " meetings; at most " << target << " could be scheduled" << endl;
+    meeting_data.os << "Greedy placement scheduled " << greedy.get_num_placed() << "; search took "
+        << elapsed << " of " << budget << " ms with " << num_threads << " threads" << endl;
+    if (best.get_num_placed() < static_cast<int>(problem.requests.size()))
+    {
+        meeting_data.os << "Not scheduled:";
+        for (size_t request = 0; request < problem.requests.size(); ++request)
+        {
+            if (!best.is_placed(request))
+            {
+                meeting_data.os << " " << problem.requests[request].topic;
+            }
+        }
+        meeting_data.os << endl;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef AUTO_SCHEDULER_H
+#define AUTO_SCHEDULER_H
+
+#include "Commands.h"
+
+/* The "sm" command places a batch of meetings at once. The rest of the line is
+
+    sm filename budget
+
+where the file holds the requests and budget is the number of milliseconds the
+search may take. The file has the number of requests, then one line for each:
+
+    topic num_times time ... num_rooms room ... num_participants lastname ...
+
+where a count of zero times or rooms allows every meeting time or every room. Each
+request is placed as a new meeting, with its participants, in one of its rooms at
+one of its times where the room has no meeting and none of its people have a
+commitment, and where no two placed requests share a room or a person at the same
+time. Requests that cannot all be placed are left out, as few as the search finds.
+
+The search starts from a greedy placement, taking the requests with the fewest
+(room, time) choices first. Then, until the budget runs out or the most that could
+be placed are placed, a worker thread per processor improves its own copy of the
+placement: it takes a request that was left out, finds the choice for it that
+displaces the fewest placed requests, displaces them, and places each of them again
+where it fits. The move is kept if no fewer requests end up placed; one in ten of the
+moves that leave fewer placed is kept anyway, so that the search can leave a
+placement that no single move improves. The room and person bitmaps of the slots
+make every check one word, and a table of which request holds each room and person
+in each slot finds the displaced ones directly.
+
+The best placement found is added to the schedule by the one command, so no other
+command sees part of it, and the number placed is reported against the number of
+requests, the most that could be placed (those that could be placed on their own, or
+the free slots of their rooms if there are fewer), and the time used of the budget.
+Errors: file cannot be opened, invalid data in file, no person or room of a name or
+number, a time out of range, a person listed twice in a request, budget not an integer
+or negative.
+*/
+
+// Function that handles the "sm" command.
+void cmd_schedule_meetings(MeetingData& meeting_data);
+
+#endif
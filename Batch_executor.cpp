@@ -0,0 +1,403 @@
+#include "Batch_executor.h"
+#include "Slot_finder.h"
+#include "Work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+using namespace std;
+
+// a command of the script and its place in the DAG
+struct Batch_command {
+    Batch_command() : num_dependencies(0) {}
+    string output;
+    exception_ptr failure;
+    // the commands that depend on this one
+    vector<int> dependents;
+    // the number of commands this one depends on that have not finished yet
+    atomic<int> num_dependencies;
+};
+
+Batch_executor::Batch_executor(Room_t& rooms_, People_t& people_, Change_feed& feed_, int num_threads_) :
+    rooms(rooms_), people(people_), feed(feed_), num_threads(max(num_threads_, 1))
+{}
+
+// The words after the command name that each command reads from its line when it
+// succeeds, one pattern for each form of the command: i is an integer, w any word,
+// d a word starting with a digit, o a word starting with the first letter of the
+// near option, and * the rest of the line.
+static const map<string, vector<string>> argument_patterns
+{
+    {"pi", {"w"}}, {"pc", {"w"}}, {"pt", {"w", "wi"}}, {"pf", {"w"}},
+    {"fr", {"i"}}, {"br", {"i"}}, {"bp", {"i"}},
+    {"fs", {"*"}}, {"fa", {"*"}}, {"fc", {"i*"}},
+    {"pr", {"i"}}, {"pm", {"ii"}}, {"ps", {"", "i", "iw"}}, {"pg", {"", "i", "iw"}}, {"pa", {""}},
+    {"pd", {"iww"}}, {"pe", {"www"}},
+    {"ai", {"www"}}, {"ar", {"i", "id*"}}, {"rc", {"ii*"}},
+    {"am", {"iiw", "iiwo*"}}, {"at", {"iww"}}, {"ap", {"iiw"}}, {"sm", {"wi"}},
+    {"ad", {"iwww"}}, {"ac", {"iwwiww"}}, {"ae", {"iwiw"}},
+    {"rm", {"iiii", "iiiio*"}}, {"rd", {"iwiiwi"}},
+    {"di", {"w"}}, {"dr", {"i"}}, {"dm", {"ii"}}, {"dp", {"iiw"}}, {"de", {"iwiw"}},
+    {"dd", {"iwi"}}, {"dx", {"iwi"}}, {"ds", {""}}, {"dg", {""}}, {"da", {""}},
+    {"sd", {"w"}}, {"ld", {"w"}}, {"qu", {"*"}},
+    {"wr", {"ii", "iii"}}, {"wp", {"", "i"}}, {"wc", {"i"}}, {"wu", {"i"}}
+};
+
+// Returns true if a command reading the words as the pattern says reads all of them
+// and no more, or fails at one of them. An integer that cannot be read fails the command.
+static bool fits_pattern(const vector<string>& words, const string& pattern)
+{
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        if (pattern[i] == '*')
+        {
+            return true;
+        }
+        if (i == words.size())
+        {
+            return false;
+        }
+        const string& word = words[i];
+        unsigned char first = word[0];
+        switch (pattern[i])
+        {
+            case 'i':
+            {
+                size_t first_digit = (first == '+' || first == '-') ? 1 : 0;
+                if (!first_digit && !isdigit(first))
+                {
+                    return true;
+                }
+                if (first_digit == word.size() || word.find_first_not_of("0123456789", first_digit) != string::npos)
+                {
+                    return false;
+                }
+                break;
+            }
+            case 'd':
+                if (!isdigit(first))
+                {
+                    return false;
+                }
+                break;
+            case 'o':
+                if (first != 'n')
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+    return words.size() == pattern.size();
+}
+
+// Returns true if the line holds one command that reads its arguments from the line only.
+static bool is_single_command(const string& line)
+{
+    istringstream is(line);
+    string cmd;
+    is >> cmd;
+    if (cmd.size() != 2)
+    {
+        return false;
+    }
+    // an unrecognized command fails.
+    if (!find_command(cmd))
+    {
+        return true;
+    }
+    auto patterns_it = argument_patterns.find(cmd);
+    if (patterns_it == argument_patterns.end())
+    {
+        return false;
+    }
+    vector<string> words;
+    string word;
+    while (is >> word)
+    {
+        words.push_back(word);
+    }
+    const vector<string>& patterns = patterns_it->second;
+    return any_of(patterns.begin(), patterns.end(),
+            [&words](const string& pattern){ return fits_pattern(words, pattern); });
+}
+
+void Batch_executor::execute(const vector<string>& commands, ostream& os)
+{
+    if (num_threads == 1 || !all_of(commands.begin(), commands.end(), is_single_command))
+    {
+        execute_serially(commands, os);
+    }
+    else
+    {
+        execute_in_parallel(commands, os);
+    }
+}
+
+void Batch_executor::execute_serially(const vector<string>& commands, ostream& os)
+{
+    // the lines are read as one stream, as the interactive loop reads its input.
+    string script;
+    for (const string& command : commands)
+    {
+        script += command + "\n";
+    }
+    istringstream is(script);
+    MeetingData meeting_data(rooms, people, is, os, nullptr, &feed);
+    while (is >> ws && !is.eof())
+    {
+        Change_scope scope(feed, feed.get_version() + 1);
+        if (!execute_command(meeting_data))
+        {
+            // skip the rest of the line.
+            is.ignore(numeric_limits<streamsize>::max(), '\n');
+        }
+    }
+}
+
+Batch_executor::Accesses_t Batch_executor::find_accesses(const string& command)
+{
+    istringstream is(command);
+    string cmd = read_command_name(is);
+
+    const Access room_list_read{room_list_c, "", false, false};
+    const Access room_list_write{room_list_c, "", false, true};
+    const Access people_list_read{people_list_c, "", false, false};
+    const Access people_list_write{people_list_c, "", false, true};
+    const Access all_rooms_read{room_c, "", true, false};
+    const Access all_rooms_write{room_c, "", true, true};
+    const Access all_people_read{person_c, "", true, false};
+    const Access all_people_write{person_c, "", true, true};
+    const Access all_files_write{file_c, "", true, true};
+    const Accesses_t everything{room_list_write, people_list_write, all_rooms_write, all_people_write, all_files_write};
+
+    // read the arguments that name what the command accesses; if a number cannot
+    // be read, the command fails partway and what it accessed is not known.
+    int room_number = 0, time = 0, new_room_number = 0;
+    string date;
+    if (cmd == "pr" || cmd == "am" || cmd == "at" || cmd == "dr" || cmd == "ad" || cmd == "ac" || cmd == "pd" || cmd == "rc")
+    {
+        is >> room_number;
+    }
+    else if (cmd == "ae" || cmd == "de" || cmd == "dd" || cmd == "dx")
+    {
+        is >> room_number >> date >> time;
+    }
+    else if (cmd == "rd")
+    {
+        is >> room_number >> date >> time >> new_room_number;
+    }
+    else if (cmd == "pm" || cmd == "dm" || cmd == "ap" || cmd == "dp")
+    {
+        is >> room_number >> time;
+    }
+    else if (cmd == "rm")
+    {
+        is >> room_number >> time >> new_room_number;
+    }
+    if (!is)
+    {
+        return everything;
+    }
+    // with the near option, the room the meeting goes to is only known once it is found.
+    if ((cmd == "am" || cmd == "rm") && has_nearest_option(command))
+    {
+        return {room_list_read, all_rooms_write, people_list_read, all_people_write};
+    }
+    // a last name, or the file name for sd.
+    string name;
+    is >> name;
+    const Access room_write{room_c, to_string(room_number), false, true};
+    const Access person_read{person_c, name, false, false};
+    const Access person_write{person_c, name, false, true};
+
+    if (cmd == "pi" || cmd == "pc" || cmd == "pt")
+        return {people_list_read, person_read};
+    else if (cmd == "pr" || cmd == "pm" || cmd == "pd")
+        return {room_list_read, Access{room_c, to_string(room_number), false, false}};
+    else if (cmd == "pe")
+        return {people_list_read, person_read};
+    else if (cmd == "ps" || cmd == "fr" || cmd == "br" || cmd == "fc")
+        return {room_list_read, all_rooms_read};
+    else if (cmd == "pg" || cmd == "pf" || cmd == "bp")
+        return {people_list_read, all_people_read};
+    else if (cmd == "pa")
+        return {room_list_read, people_list_read, all_rooms_read};
+    else if (cmd == "qu" || cmd == "fs" || cmd == "fa")
+        return {room_list_read, people_list_read, all_rooms_read, all_people_read};
+    else if (cmd == "ai")
+        return {people_list_write};
+    else if (cmd == "ar")
+        return {room_list_write};
+    // the room moves in the directory's order of capacity.
+    else if (cmd == "rc")
+        return {room_list_write, room_write};
+    else if (cmd == "am" || cmd == "at" || cmd == "ad" || cmd == "ac")
+        return {room_list_read, room_write};
+    else if (cmd == "ap" || cmd == "dp" || cmd == "ae" || cmd == "de")
+        return {room_list_read, room_write, people_list_read, person_write};
+    // these change the commitments of a meeting's participants, who are not named.
+    else if (cmd == "rm" || cmd == "rd")
+        return {room_list_read, room_write, Access{room_c, to_string(new_room_number), false, true},
+            people_list_read, all_people_write};
+    // cancelling an occurrence takes it out of the participants' commitments too.
+    else if (cmd == "dm" || cmd == "dd" || cmd == "dx")
+        return {room_list_read, room_write, people_list_read, all_people_write};
+    else if (cmd == "dr")
+        return {room_list_write, people_list_read, all_people_write};
+    // whether the person is a participant is found from their commitments.
+    else if (cmd == "di")
+        return {people_list_write, person_write};
+    else if (cmd == "ds")
+        return {room_list_read, people_list_read, all_rooms_write, all_people_write};
+    // the rooms and people placed are only known once the requests are read.
+    else if (cmd == "sm")
+        return {room_list_read, people_list_read, all_rooms_write, all_people_write,
+            Access{file_c, name, false, false}};
+    else if (cmd == "dg")
+        return {room_list_read, all_rooms_read, people_list_write};
+    else if (cmd == "sd")
+        return {room_list_read, people_list_read, all_rooms_read, all_people_read,
+            Access{file_c, name, false, true}};
+    else if (find_command(cmd))
+        return everything;
+    // an unrecognized command only reports an error.
+    return {};
+}
+
+// add the command to the dependencies unless it is none.
+static void add_dependency(vector<int>& dependencies, int command_index)
+{
+    if (command_index >= 0)
+    {
+        dependencies.push_back(command_index);
+    }
+}
+
+void Batch_executor::add_access(int command_index, const Access& access, vector<int>& dependencies)
+{
+    Kind_state& kind_state = kind_states[access.kind];
+    Resource_state& all = kind_state.all;
+    if (!access.all)
+    {
+        Resource_state& resource = kind_state.resources[access.key];
+        add_dependency(dependencies, resource.last_writer);
+        add_dependency(dependencies, all.last_writer);
+        if (access.write)
+        {
+            dependencies.insert(dependencies.end(), resource.readers.begin(), resource.readers.end());
+            dependencies.insert(dependencies.end(), all.readers.begin(), all.readers.end());
+            resource.last_writer = command_index;
+            resource.readers.clear();
+        }
+        else
+        {
+            resource.readers.push_back(command_index);
+        }
+        return;
+    }
+
+    add_dependency(dependencies, all.last_writer);
+    for (auto& resource_pair : kind_state.resources)
+    {
+        add_dependency(dependencies, resource_pair.second.last_writer);
+        if (access.write)
+        {
+            dependencies.insert(dependencies.end(),
+                    resource_pair.second.readers.begin(), resource_pair.second.readers.end());
+        }
+    }
+    if (access.write)
+    {
+        dependencies.insert(dependencies.end(), all.readers.begin(), all.readers.end());
+        // later accesses to any resource of the kind conflict with this one.
+        kind_state.resources.clear();
+        all.last_writer = command_index;
+        all.readers.clear();
+    }
+    else
+    {
+        all.readers.push_back(command_index);
+    }
+}
+
+void Batch_executor::execute_in_parallel(const vector<string>& commands, ostream& os)
+{
+    int num_commands = commands.size();
+    unique_ptr<Batch_command[]> batch(new Batch_command[num_commands]);
+
+    // build the DAG in script order.
+    for_each(begin(kind_states), end(kind_states), [](Kind_state& kind_state){ kind_state = Kind_state(); });
+    for (int i = 0; i < num_commands; ++i)
+    {
+        vector<int> dependencies;
+        for (const Access& access : find_accesses(commands[i]))
+        {
+            add_access(i, access, dependencies);
+        }
+        sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        // a command that both reads and writes a resource must not depend on itself.
+        dependencies.erase(remove(dependencies.begin(), dependencies.end(), i), dependencies.end());
+        batch[i].num_dependencies = dependencies.size();
+        for (int dependency : dependencies)
+        {
+            batch[dependency].dependents.push_back(i);
+        }
+    }
+
+    // the commands are numbered in script order, whatever order they run in.
+    uint64_t first_version = feed.get_version() + 1;
+    Work_stealing_pool pool(num_threads);
+    // run a command, then any dependents it was the last to wait for.
+    function<void(int)> run_command = [this, &commands, &batch, &pool, &run_command, first_version](int index)
+    {
+        Batch_command& command = batch[index];
+        try{
+            istringstream is(commands[index]);
+            ostringstream os;
+            MeetingData meeting_data(rooms, people, is, os, nullptr, &feed);
+            Change_scope scope(feed, first_version + index);
+            execute_command(meeting_data);
+            command.output = os.str();
+        }
+        catch(...)
+        {
+            command.failure = current_exception();
+        }
+        for (int dependent : command.dependents)
+        {
+            if (--batch[dependent].num_dependencies == 0)
+            {
+                pool.submit(bind(run_command, dependent));
+            }
+        }
+    };
+    // find the commands that are ready before any of them can finish.
+    vector<int> ready;
+    for (int i = 0; i < num_commands; ++i)
+    {
+        if (batch[i].num_dependencies == 0)
+        {
+            ready.push_back(i);
+        }
+    }
+    for (int index : ready)
+    {
+        pool.submit(bind(run_command, index));
+    }
+    pool.wait();
+
+    for (int i = 0; i < num_commands; ++i)
+    {
+        if (batch[i].failure)
+        {
+            rethrow_exception(batch[i].failure);
+        }
+        os << batch[i].output;
+    }
+}
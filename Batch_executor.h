@@ -0,0 +1,92 @@
+#ifndef BATCH_EXECUTOR_H
+#define BATCH_EXECUTOR_H
+
+#include "Commands.h"
+#include "Change_feed.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* A Batch_executor runs a script of commands against one schedule, running commands
+that cannot affect each other in parallel.
+
+Before running anything, each command's arguments are parsed to find the data it
+can read and write: the list of rooms, the list of people, individual rooms by
+number, individual people by last name, and files by name. Two commands conflict
+if they access the same data and at least one of them writes it; each command
+depends on the conflicting commands before it, which makes the script a DAG. The
+commands are then run on a Work_stealing_pool, each one as soon as the commands it
+depends on have finished, writing its output to its own buffer.
+
+Since conflicting commands still run in script order and each command's output
+is written in script order, the schedule and the output (including the error
+messages) are exactly those of running the commands one at a time. A command
+whose accesses cannot be determined from its arguments conflicts with everything,
+as do the commands of the change feed. Each command records its changes in the
+feed with the version it would have had if run on its own, so the feed is also
+that of running the commands one at a time.
+
+The interactive loop reads commands from its input as a stream, so a line may hold
+several commands, and a command missing arguments reads them from the next line.
+The DAG is only used when each line is known to hold exactly one command whose
+arguments all come from that line: every word after the command name is one it
+reads, or one it fails at, which skips the rest of the line. Any other script is
+run one command at a time from a single stream, as the interactive loop runs it.
+*/
+
+class Batch_executor {
+public:
+    // Run commands against the schedule, recording its changes in the feed,
+    // on the specified number of threads; with one thread, the commands are
+    // simply run one at a time.
+    Batch_executor(Room_t& rooms_, People_t& people_, Change_feed& feed_, int num_threads_);
+
+    // Run the script lines and write their output to the stream in order.
+    // An exception other than Error thrown by a command is rethrown after
+    // the output of the commands before it has been written.
+    void execute(const std::vector<std::string>& commands, std::ostream& os);
+
+private:
+    enum Resource_kind { room_list_c, people_list_c, room_c, person_c, file_c, num_resource_kinds_c };
+
+    // an access to one resource of a kind, or to all of them if all is true
+    struct Access {
+        Resource_kind kind;
+        std::string key;
+        bool all;
+        bool write;
+    };
+    using Accesses_t = std::vector<Access>;
+
+    // the commands that last accessed a resource
+    struct Resource_state {
+        Resource_state() : last_writer(-1) {}
+        int last_writer;
+        // the commands that read it since last_writer
+        std::vector<int> readers;
+    };
+    struct Kind_state {
+        std::map<std::string, Resource_state> resources;
+        // the commands that accessed all resources of the kind
+        Resource_state all;
+    };
+
+    // Returns the accesses the command line can make.
+    static Accesses_t find_accesses(const std::string& command);
+
+    // Adds the commands before command_index that conflict with the access to dependencies,
+    // and records the access.
+    void add_access(int command_index, const Access& access, std::vector<int>& dependencies);
+
+    void execute_serially(const std::vector<std::string>& commands, std::ostream& os);
+    void execute_in_parallel(const std::vector<std::string>& commands, std::ostream& os);
+
+    Room_t& rooms;
+    People_t& people;
+    Change_feed& feed;
+    int num_threads;
+    Kind_state kind_states[num_resource_kinds_c];
+};
+
+#endif
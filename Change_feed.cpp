@@ -0,0 +1,264 @@
+#include "Change_feed.h"
+#include "Utility.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+// string literals
+const char* const no_subscription_message_c = "No subscription with that number!";
+
+// the feed and version that the changes made on this thread are recorded in
+static thread_local Change_feed* current_feed = nullptr;
+static thread_local uint64_t current_version = 0;
+
+uint64_t Change_feed::get_version() const
+{
+    return version.load();
+}
+
+int Change_feed::watch_rooms(int first_room, int last_room, uint64_t since)
+{
+    auto locks = lock_all_shards();
+    int subscription = next_subscription++;
+    subscriptions[subscription] = Subscription{true, first_room, last_room};
+    for (Shard& shard : shards)
+    {
+        // the rooms are ordered by number, so only the range is examined.
+        for (auto room_it = shard.room_versions.lower_bound(first_room);
+                room_it != shard.room_versions.end() && room_it->first <= last_room; ++room_it)
+        {
+            if (room_it->second > since)
+            {
+                shard.undelivered[subscription].rooms[room_it->first] = room_it->second;
+            }
+        }
+    }
+    index_subscriptions();
+    return subscription;
+}
+
+int Change_feed::watch_people(uint64_t since)
+{
+    auto locks = lock_all_shards();
+    int subscription = next_subscription++;
+    subscriptions[subscription] = Subscription{false, 0, 0};
+    for (Shard& shard : shards)
+    {
+        for (const auto& person_version : shard.person_versions)
+        {
+            if (person_version.second > since)
+            {
+                shard.undelivered[subscription].people[person_version.first] = person_version.second;
+            }
+        }
+    }
+    index_subscriptions();
+    return subscription;
+}
+
+const Change_feed::Subscription& Change_feed::find_subscription(int subscription) const
+{
+    auto subscription_it = subscriptions.find(subscription);
+    if (subscription_it == subscriptions.end())
+    {
+        throw Error(no_subscription_message_c);
+    }
+    return subscription_it->second;
+}
+
+void Change_feed::print_changes(int subscription, ostream& os)
+{
+    auto locks = lock_all_shards();
+    find_subscription(subscription);
+    // gather the changes from every shard, which also puts them in order.
+    Undelivered changes;
+    for (Shard& shard : shards)
+    {
+        auto undelivered_it = shard.undelivered.find(subscription);
+        if (undelivered_it != shard.undelivered.end())
+        {
+            changes.rooms.insert(undelivered_it->second.rooms.begin(), undelivered_it->second.rooms.end());
+            changes.people.insert(undelivered_it->second.people.begin(), undelivered_it->second.people.end());
+            shard.undelivered.erase(undelivered_it);
+        }
+    }
+    os << "Subscription " << subscription << " changes up to version " << version.load() << ":" << endl;
+    if (changes.rooms.empty() && changes.people.empty())
+    {
+        os << "No changes" << endl;
+    }
+    for (const auto& room_version : changes.rooms)
+    {
+        os << "Room " << room_version.first << " changed in version " << room_version.second << endl;
+    }
+    for (const auto& person_version : changes.people)
+    {
+        os << "Person " << person_version.first << " changed in version " << person_version.second << endl;
+    }
+}
+
+void Change_feed::cancel(int subscription)
+{
+    auto locks = lock_all_shards();
+    find_subscription(subscription);
+    subscriptions.erase(subscription);
+    for (Shard& shard : shards)
+    {
+        shard.undelivered.erase(subscription);
+    }
+    index_subscriptions();
+}
+
+/*
+ * Rebuilds the index of the subscriptions watching each range of rooms and of
+ * those watching people. Every shard must be locked.
+ */
+void Change_feed::index_subscriptions()
+{
+    // a range of rooms starts at each first room watched and after each last one.
+    set<int> range_starts;
+    for (const auto& subscription_pair : subscriptions)
+    {
+        const Subscription& subscription = subscription_pair.second;
+        if (subscription.rooms)
+        {
+            range_starts.insert(subscription.first_room);
+            if (subscription.last_room < numeric_limits<int>::max())
+            {
+                range_starts.insert(subscription.last_room + 1);
+            }
+        }
+    }
+    room_watchers.clear();
+    people_watchers.clear();
+    for (int range_start : range_starts)
+    {
+        vector<int>& watchers = room_watchers[range_start];
+        for (const auto& subscription_pair : subscriptions)
+        {
+            const Subscription& subscription = subscription_pair.second;
+            if (subscription.rooms && subscription.first_room <= range_start && range_start <= subscription.last_room)
+            {
+                watchers.push_back(subscription_pair.first);
+            }
+        }
+    }
+    for (const auto& subscription_pair : subscriptions)
+    {
+        if (!subscription_pair.second.rooms)
+        {
+            people_watchers.push_back(subscription_pair.first);
+        }
+    }
+}
+
+Change_feed::Shard& Change_feed::room_shard(int room_number)
+{
+    return shards[static_cast<unsigned int>(room_number) % num_feed_shards_c];
+}
+
+Change_feed::Shard& Change_feed::person_shard(const string& lastname)
+{
+    return shards[hash<string>()(lastname) % num_feed_shards_c];
+}
+
+vector<unique_lock<mutex>> Change_feed::lock_all_shards()
+{
+    vector<unique_lock<mutex>> locks;
+    locks.reserve(num_feed_shards_c);
+    for (Shard& shard : shards)
+    {
+        locks.emplace_back(shard.shard_mutex);
+    }
+    return locks;
+}
+
+void Change_feed::record_room(int room_number, uint64_t change_version, bool deleted)
+{
+    Shard& shard = room_shard(room_number);
+    lock_guard<mutex> lock(shard.shard_mutex);
+    uint64_t& room_version = shard.room_versions[room_number];
+    room_version = max(room_version, change_version);
+    auto watchers_it = room_watchers.upper_bound(room_number);
+    if (watchers_it != room_watchers.begin())
+    {
+        for (int subscription : prev(watchers_it)->second)
+        {
+            shard.undelivered[subscription].rooms[room_number] = room_version;
+        }
+    }
+    if (deleted)
+    {
+        shard.room_versions.erase(room_number);
+    }
+}
+
+void Change_feed::record_person(const string& lastname, uint64_t change_version, bool deleted)
+{
+    Shard& shard = person_shard(lastname);
+    lock_guard<mutex> lock(shard.shard_mutex);
+    uint64_t& person_version = shard.person_versions[lastname];
+    person_version = max(person_version, change_version);
+    for (int subscription : people_watchers)
+    {
+        shard.undelivered[subscription].people[lastname] = person_version;
+    }
+    if (deleted)
+    {
+        shard.person_versions.erase(lastname);
+    }
+}
+
+Change_scope::Change_scope(Change_feed& feed, uint64_t version) :
+    previous_feed(current_feed), previous_version(current_version)
+{
+    // the feed's version only grows, though the scopes of a batch may start out of order.
+    uint64_t feed_version = feed.version.load();
+    while (feed_version < version && !feed.version.compare_exchange_weak(feed_version, version))
+    {
+    }
+    current_feed = &feed;
+    current_version = version;
+}
+
+Change_scope::~Change_scope()
+{
+    current_feed = previous_feed;
+    current_version = previous_version;
+}
+
+void record_room_change(int room_number)
+{
+    if (current_feed)
+    {
+        current_feed->record_room(room_number, current_version, false);
+    }
+}
+
+void record_person_change(const string& lastname)
+{
+    if (current_feed)
+    {
+        current_feed->record_person(lastname, current_version, false);
+    }
+}
+
+void record_room_deletion(int room_number)
+{
+    if (current_feed)
+    {
+        current_feed->record_room(room_number, current_version, true);
+    }
+}
+
+void record_person_deletion(const string& lastname)
+{
+    if (current_feed)
+    {
+        current_feed->record_person(lastname, current_version, true);
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* A Change_feed records which rooms and people of a schedule have changed, so that
+clients can find out about changes without printing and comparing the schedule.
+
+Every command run on a schedule has a version: the commands are numbered from 1 in
+the order they are given. The feed keeps, for each room and person, the version of
+the last command that changed it; the mutators of Room and Person report their
+changes with record_room_change and record_person_change, which record them in the
+feed of the Change_scope the thread is running a command in. Changes made outside
+of any Change_scope are not recorded.
+
+A subscription watches a range of room numbers or all people. The changes it has not
+delivered yet are coalesced: an entity changed by a burst of commands is delivered
+once, with the version of its latest change, when the subscriber next asks for them.
+A failed command may report a change to an entity that it has restored.
+The commands
+    wr first last [since]   watch rooms first to last
+    wp [since]              watch people
+    wc subscription         print the changes not delivered yet
+    wu subscription         cancel the subscription
+give clients access to the feed.
+
+When a room or person is deleted, the deletion is delivered as a change to the
+subscriptions watching it, and the feed forgets the entity's version, so a
+subscription made later does not report an entity deleted before it started.
+
+Changes may be recorded by several threads at once (as the batch executor does
+for commands that change different rooms). The rooms and people are spread over
+shards, each with its own mutex, which holds their versions and the changes not
+delivered yet to each subscription; recording a change locks only the entity's
+shard, and finds the subscriptions watching it in an index of the room ranges.
+Subscribing, cancelling and delivering lock every shard, in order, and are the
+only operations that change the subscriptions and the index.
+*/
+
+// the number of shards the rooms and people of a Change_feed are spread over
+const int num_feed_shards_c = 16;
+
+class Change_feed {
+public:
+    Change_feed() : version(0), next_subscription(1) {}
+
+    Change_feed(const Change_feed&) = delete;
+    Change_feed& operator= (const Change_feed&) = delete;
+
+    // Returns the version of the latest command run in a Change_scope of the feed.
+    std::uint64_t get_version() const;
+
+    // Subscribe to the changes to the rooms first_room to last_room, or to all
+    // people, that were made after the since version, and return the subscription number.
+    int watch_rooms(int first_room, int last_room, std::uint64_t since);
+    int watch_people(std::uint64_t since);
+
+    // Write the changes the subscription has not delivered yet as one notification,
+    // and mark them delivered. Throws Error if there is no such subscription.
+    void print_changes(int subscription, std::ostream& os);
+
+    // Cancel the subscription. Throws Error if there is no such subscription.
+    void cancel(int subscription);
+
+private:
+    friend class Change_scope;
+    friend void record_room_change(int room_number);
+    friend void record_person_change(const std::string& lastname);
+
+// Record the deletion of the room or person as a change, and forget its version.
+void record_room_deletion(int room_number);
+void record_person_deletion(const std::string& lastname);
+    friend void record_room_deletion(int room_number);
+    friend void record_person_deletion(const std::string& lastname);
+
+    struct Subscription {
+        bool rooms;
+        int first_room;
+        int last_room;
+    };
+
+    // the changes not delivered yet to a subscription, with the version of the
+    // latest change to each entity
+    struct Undelivered {
+        std::map<int, std::uint64_t> rooms;
+        std::map<std::string, std::uint64_t> people;
+    };
+
+    struct Shard {
+        std::mutex shard_mutex;
+        // the version of the last change to each room and person of the shard
+        std::map<int, std::uint64_t> room_versions;
+        std::map<std::string, std::uint64_t> person_versions;
+        // the undelivered changes to the shard's entities, by subscription number
+        std::map<int, Undelivered> undelivered;
+    };
+
+    void record_room(int room_number, std::uint64_t change_version, bool deleted);
+    void record_person(const std::string& lastname, std::uint64_t change_version, bool deleted);
+    Shard& room_shard(int room_number);
+    Shard& person_shard(const std::string& lastname);
+    std::vector<std::unique_lock<std::mutex>> lock_all_shards();
+    const Subscription& find_subscription(int subscription) const;
+    void index_subscriptions();
+
+    std::atomic<std::uint64_t> version;
+    Shard shards[num_feed_shards_c];
+    // The subscriptions and their index are changed only while every shard is
+    // locked, so they can be read while any one shard is locked.
+    std::map<int, Subscription> subscriptions;
+    // each key starts a range of room numbers, ending before the next key,
+    // that is watched by the listed subscriptions
+    std::map<int, std::vector<int>> room_watchers;
+    std::vector<int> people_watchers;
+    int next_subscription;
+};
+
+/* While a Change_scope exists, the changes made on its thread are recorded in the
+feed as changes of the command with the specified version, which also becomes the
+feed's version if it is later. */
+class Change_scope {
+public:
+    Change_scope(Change_feed& feed, std::uint64_t version);
+    ~Change_scope();
+
+    Change_scope(const Change_scope&) = delete;
+    Change_scope& operator= (const Change_scope&) = delete;
+
+private:
+    Change_feed* previous_feed;
+    std::uint64_t previous_version;
+};
+
+// Record a change to the room or person in the feed of the thread's Change_scope, if any.
+void record_room_change(int room_number);
+void record_person_change(const std::string& lastname);
+
+// Record the deletion of the room or person as a change, and forget its version.
+void record_room_deletion(int room_number);
+void record_person_deletion(const std::string& lastname);
+
+#endif
@@ -0,0 +1,1454 @@
+#include "Commands.h"
+#include "Auto_scheduler.h"
+#include "Change_feed.h"
+#include "Dated_commands.h"
+#include "Person.h"
+#include "Published_schedule.h"
+#include "Query.h"
+#include "Slot_finder.h"
+#include "Meeting.h"
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <new>
+#include <functional>
+#include <map>
+#include <sstream>
+
+using namespace std;
+
+// class that overloads the function operator
+// to calculate the sum of the meetings of all the rooms
+// by incrementing sum each time it is called with a room
+class Calc_Sum_Meetings {
+
+    public:
+        Calc_Sum_Meetings() : sum(0) {}
+        void operator() (Room& room)
+        {
+            sum += room.get_number_Meetings();
+        }
+
+        int get_sum() const
+        {                   
+            return sum;
+        }
+
+    private:
+        int sum;
+};   
+
+// string literals  
+const char* const person_is_participant_message_c = "This person is a participant in a meeting!";
+const char* const all_persons_deleted_message_c = "All persons deleted";
+const char* const all_meetings_deleted_message_c = "All meetings deleted";
+const char* const bad_page_limit_message_c = "Page limit must be positive!";
+const char* const bad_cursor_message_c = "Invalid cursor!";
+const char* const no_change_feed_message_c = "Changes are not being recorded!";
+const char* const bad_capacity_message_c = "Capacity is not in range!";
+const char* const unknown_attribute_message_c = "Unknown room attribute!";
+
+
+// Prototypes for functions that handle print commands and their helpers. 
+static void cmd_print_individual(MeetingData& meeting_data);
+static void cmd_print_person_commitments(MeetingData& meeting_data);
+static void cmd_print_agenda(MeetingData& meeting_data);
+static void cmd_print_people_with_prefix(MeetingData& meeting_data);
+static void print_rooms_at(MeetingData& meeting_data, bool busy);
+static void cmd_print_free_rooms(MeetingData& meeting_data);
+static void cmd_print_busy_rooms(MeetingData& meeting_data);
+static void cmd_print_busy_people(MeetingData& meeting_data);
+static void skip_blanks(istream& is);
+static void cmd_print_room(MeetingData& meeting_data);
+static void cmd_print_meeting(MeetingData& meeting_data);
+static void cmd_print_all_meetings(MeetingData& meeting_data);
+static void cmd_print_all_people(MeetingData& meeting_data);
+static void cmd_print_allocated(MeetingData& meeting_data);
+static void read_room_features(istream& is, int& capacity, unsigned int& attributes);
+static void cmd_find_room_for(MeetingData& meeting_data);
+
+// Prototypes for functions that handle add commands. 
+static void cmd_add_individual(MeetingData& meeting_data);
+static void cmd_add_room(MeetingData& meeting_data);
+static void cmd_set_room_capacity(MeetingData& meeting_data);
+static void cmd_add_meeting(MeetingData& meeting_data);
+static void cmd_add_timed_meeting(MeetingData& meeting_data);
+static void cmd_add_participant(MeetingData& meeting_data);
+static void print_nearest_slots(ostream& os, const vector<Room_time>& nearest);
+
+// Prototype for reschedule meeting command. 
+static void cmd_reschedule_meeting(MeetingData& meeting_data);
+
+// Prototypes for functions that handle delete commands and their helpers. 
+static void cmd_delete_individual(MeetingData& meeting_data);
+static void cmd_delete_room(MeetingData& meeting_data);
+static void cmd_delete_meeting(MeetingData& meeting_data);
+static void cmd_delete_participant(MeetingData& meeting_data);
+static void cmd_delete_schedule(MeetingData& meeting_data);
+static void clear_people_list(People_t& people);
+static void cmd_delete_all_individuals(MeetingData& meeting_data);
+static void clear_room_list(Room_t& rooms);
+static void cmd_delete_all(MeetingData& meeting_data);
+
+/* 
+ * Prototypes for functions that handle save and load commands and their
+ * helpers. 
+ */
+static void cmd_save_data(MeetingData& meeting_data);
+static void record_schedule_changes(const Room_t& rooms, const People_t& people);
+static void roll_back(Room_t& rooms, People_t& people, Room_t& rooms_backup, People_t& people_backup, ifstream& is);
+static void cmd_load_data(MeetingData& meeting_data);
+
+// Prototypes for functions that handle the change feed commands and their helpers.
+static Change_feed& get_change_feed(MeetingData& meeting_data);
+static uint64_t read_since_version(MeetingData& meeting_data);
+static void cmd_watch_rooms(MeetingData& meeting_data);
+static void cmd_watch_people(MeetingData& meeting_data);
+static void cmd_watch_changes(MeetingData& meeting_data);
+static void cmd_watch_cancel(MeetingData& meeting_data);
+
+// map of commands to their function pointers
+static const map<string, Command_func_t> cmd_mapper
+{
+    {"pi", cmd_print_individual},
+    {"pc", cmd_print_person_commitments},
+    {"pt", cmd_print_agenda},
+    {"pf", cmd_print_people_with_prefix},
+    {"fr", cmd_print_free_rooms},
+    {"br", cmd_print_busy_rooms},
+    {"bp", cmd_print_busy_people},
+    {"fs", cmd_find_slot},
+    {"fa", cmd_find_all_slots},
+    {"fc", cmd_find_room_for},
+    {"pr", cmd_print_room},
+    {"pm", cmd_print_meeting},
+    {"ps", cmd_print_all_meetings},
+    {"pg", cmd_print_all_people},
+    {"pa", cmd_print_allocated},
+    {"pd", cmd_print_room_dates},
+    {"pe", cmd_print_person_dates},
+    {"ai", cmd_add_individual},
+    {"ar", cmd_add_room},
+    {"am", cmd_add_meeting},
+    {"at", cmd_add_timed_meeting},
+    {"ap", cmd_add_participant},
+    {"sm", cmd_schedule_meetings},
+    {"ad", cmd_add_dated_meeting},
+    {"ac", cmd_add_repeating_meeting},
+    {"ae", cmd_add_dated_participant},
+    {"rm", cmd_reschedule_meeting},
+    {"rd", cmd_reschedule_occurrence},
+    {"rc", cmd_set_room_capacity},
+    {"di", cmd_delete_individual},
+    {"dr", cmd_delete_room},
+    {"dm", cmd_delete_meeting},
+    {"dp", cmd_delete_participant},
+    {"de", cmd_delete_dated_participant},
+    {"dd", cmd_delete_dated_meeting},
+    {"dx", cmd_cancel_occurrence},
+    {"ds", cmd_delete_schedule},
+    {"dg", cmd_delete_all_individuals},
+    {"da", cmd_delete_all},
+    {"sd", cmd_save_data},
+    {"ld", cmd_load_data},
+    {"qu", cmd_query},
+    {"wr", cmd_watch_rooms},
+    {"wp", cmd_watch_people},
+    {"wc", cmd_watch_changes},
+    {"wu", cmd_watch_cancel}
+};
+
+Command_func_t find_command(const string& cmd)
+{
+    auto cmd_func = cmd_mapper.find(cmd);
+    return (cmd_func == cmd_mapper.end()) ? nullptr : cmd_func->second;
+}
+
+string read_command_name(istream& is)
+{
+    char input_cmd_first, input_cmd_second;
+    is >> input_cmd_first >> input_cmd_second;
+
+    string cmd = "";
+    cmd += input_cmd_first;
+    cmd += input_cmd_second;
+    return cmd;
+}
+
+bool execute_command(MeetingData& meeting_data)
+{
+    try{
+        Command_func_t cmd_func = find_command(read_command_name(meeting_data.is));
+        if (!cmd_func)
+        {
+            throw Error(invalid_command_message_c);
+        }
+        cmd_func(meeting_data);
+    }
+    // report internal errors on the schedule's output
+    catch(Error& e)
+    {
+        meeting_data.os << e.msg << endl;
+        return false;
+    }
+    return true;
+}
+
+
+/* 
+ * Reads a string from input corresponding to a person's lastname
+ * and checks if a person with that lastname exists in a the
+ * people list. Returns a pointer to the person if the person
+ * is in the people's list and throws an error if not.
+ */
+Person* find_and_get_person(istream& is, People_t& people)
+{
+    string lastname;
+    is >> lastname;
+    Person* person = people.find(lastname);
+     
+    // Throws an error message if the individual to be added is not found
+    // in the people's list.
+    if (!person)
+    {
+        throw Error(no_person_message_c);
+    }
+    return person;
+}
+/*
+ * Called when a user of the program types in the 'pi' command.
+ * Prints the specified indiviual information of the person.
+ * Errors: No person with the passed in last name.
+ */
+static void cmd_print_individual(MeetingData& meeting_data)
+{
+    const Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+    meeting_data.os << *person << endl;
+}
+
+/*
+ * Called when the user of the program types the 'pc' command.
+ * Prints the commitments of a person given the person's lastname.
+ * Errors: No person with the passed in last name.
+ */
+static void cmd_print_person_commitments(MeetingData& meeting_data)
+{
+    const Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+    person->print_commitment(meeting_data.os);
+}
+
+/*
+ * Called when the user of the program types the 'pt' command.
+ * Prints the commitments of a person in time order, or only those later
+ * than the optional time, which must be on the same line.
+ * Errors: No person with the passed in last name, time out of range.
+ */
+static void cmd_print_agenda(MeetingData& meeting_data)
+{
+    const Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+    int time = 0;
+    skip_blanks(meeting_data.is);
+    if (isdigit(meeting_data.is.peek()))
+    {
+        time = get_and_check_meeting_time(meeting_data.is);
+    }
+    bool printed = false;
+    person->for_each_commitment_after(time, [&meeting_data, &printed](int room_number, const Meeting* meeting)
+            {
+                print_commitment(meeting_data.os, room_number, meeting->get_start(), meeting->get_duration(), meeting->get_topic());
+                return printed = true;
+            });
+    if (!printed)
+    {
+        print_no_commitments(meeting_data.os);
+    }
+}
+
+/*
+ * Called when the user of the program types the 'pf' command.
+ * Prints the individual information of the people whose last name
+ * starts with the prefix, in last name order.
+ * Errors: None.
+ */
+static void cmd_print_people_with_prefix(MeetingData& meeting_data)
+{
+    string prefix;
+    meeting_data.is >> prefix;
+    auto range = meeting_data.people.prefix_range(prefix);
+    if (range.first == range.second)
+    {
+        meeting_data.os << "No people with last name starting with " << prefix << endl;
+        return;
+    }
+    meeting_data.os << "Information for " << distance(range.first, range.second)
+        << " people with last name starting with " << prefix << ":" << endl;
+    for_each(range.first, range.second,
+            [&meeting_data](const Person* person){ meeting_data.os << *person << endl;});
+}
+
+/*
+ * Prints the numbers of the rooms that have a meeting at the time read
+ * (busy), or that do not, in order on one line.
+ * Errors: time out of range.
+ */
+static void print_rooms_at(MeetingData& meeting_data, bool busy)
+{
+    int time = get_and_check_meeting_time(meeting_data.is);
+    vector<int> room_numbers = meeting_data.rooms.find_rooms_at(time, busy);
+    const char* state = busy ? "busy" : "free";
+    if (room_numbers.empty())
+    {
+        meeting_data.os << "No rooms are " << state << " at " << time << endl;
+        return;
+    }
+    meeting_data.os << "Rooms " << state << " at " << time << ": " << room_numbers.size() << endl;
+    meeting_data.os << room_numbers.front();
+    for_each(room_numbers.begin() + 1, room_numbers.end(),
+            [&meeting_data](int room_number){ meeting_data.os << ' ' << room_number; });
+    meeting_data.os << endl;
+}
+
+/*
+ * Called when the user of the program types the 'fr' command.
+ * Prints the rooms with no meeting at any time in the hour from the time.
+ * Errors: time out of range.
+ */
+static void cmd_print_free_rooms(MeetingData& meeting_data)
+{
+    print_rooms_at(meeting_data, false);
+}
+
+/*
+ * Called when the user of the program types the 'br' command.
+ * Prints the rooms with a meeting at some time in the hour from the time.
+ * Errors: time out of range.
+ */
+static void cmd_print_busy_rooms(MeetingData& meeting_data)
+{
+    print_rooms_at(meeting_data, true);
+}
+
+/*
+ * Called when the user of the program types the 'bp' command.
+ * Prints the last names of the people committed to a meeting at some
+ * time in the hour from the time, in order on one line.
+ * Errors: time out of range.
+ */
+static void cmd_print_busy_people(MeetingData& meeting_data)
+{
+    int time = get_and_check_meeting_time(meeting_data.is);
+    vector<Person*> busy_people = meeting_data.people.find_people_at(time);
+    if (busy_people.empty())
+    {
+        meeting_data.os << "No people are busy at " << time << endl;
+        return;
+    }
+    meeting_data.os << "People busy at " << time << ": " << busy_people.size() << endl;
+    meeting_data.os << busy_people.front()->get_lastname();
+    for_each(busy_people.begin() + 1, busy_people.end(),
+            [&meeting_data](const Person* person){ meeting_data.os << ' ' << person->get_lastname(); });
+    meeting_data.os << endl;
+}
+
+/*
+ * Reads a number of seats followed by the names of room attributes, to the
+ * end of the line.
+ * Errors: number not an integer or negative, unknown attribute.
+ */
+static void read_room_features(istream& is, int& capacity, unsigned int& attributes)
+{
+    capacity = read_and_check_cmd_int(is);
+    if (capacity < 0)
+    {
+        throw Error(bad_capacity_message_c);
+    }
+    istringstream names_is(read_rest_of_line(is));
+    attributes = 0;
+    string name;
+    while (names_is >> name)
+    {
+        if (!parse_room_attribute(name, attributes))
+        {
+            throw Error(unknown_attribute_message_c);
+        }
+    }
+}
+
+/*
+ * Called when the user of the program types the 'fc' command.
+ * Prints the room with the fewest seats, then the lowest number, that
+ * has no meeting at any time in the hour from the time, seats at least
+ * the number of people and has all of the attributes named after it.
+ * Errors: time out of range, number not an integer or negative,
+ * unknown attribute.
+ */
+static void cmd_find_room_for(MeetingData& meeting_data)
+{
+    int time = get_and_check_meeting_time(meeting_data.is);
+    int num_seats;
+    unsigned int attributes;
+    read_room_features(meeting_data.is, num_seats, attributes);
+    const Room* room = meeting_data.rooms.find_room_for(time, num_seats, attributes);
+    if (!room)
+    {
+        meeting_data.os << "No room is free at " << time << " for " << num_seats << " people" << endl;
+        return;
+    }
+    meeting_data.os << "Room " << room->get_room_number() << " is free at " << time
+        << " with capacity " << room->get_capacity() << endl;
+}
+
+/*
+ * Reads an integer from standard input. Whitespaces are ignored.
+ * If the datum read is not an integer, an error message is printed
+ * and unwanted characters in the input following the character 
+ * are skipped. Throws an error if the input type is not an integer.
+ */
+int read_and_check_cmd_int(istream& is)
+{
+    /* Reads one integer and checks that scanf returns 1. */
+    int cmd;
+    is >> cmd;
+    if(!is)
+    {
+        is.clear();
+        throw Error(type_not_integer_message_c);
+    }
+    return cmd;
+}
+
+/*
+ * Performs error checks on integer pointed to by the argument.
+ * The input data is first checked for whether it is an integer,
+ * and if it is, whether it is in the valid range for a room number.
+ * Returns the room number if the above checks pass; otherwise, throw
+ * an error.
+ */
+int get_and_check_room_number(istream& is)
+{
+    /* Checks if data read is an integer. */
+    int room_number = read_and_check_cmd_int(is);
+
+    /* Checks if room number is in valid range (>0) */
+    if(room_number <= 0)
+    {
+        throw Error(bad_room_range_message_c);
+    }
+    return room_number;
+}
+
+Room& find_room(Room_t& rooms, int room_number)
+{
+    /* check if room exists. */
+    Room* room = rooms.find(room_number);
+    if(!room)
+    {
+        throw Error(no_room_number_message_c);
+    } 
+    return *room;
+}
+/*
+ * Called when a user of the program types in the 'pr' command.
+ * Prints the meeting in a room with the specified number.
+ * Errors: Room number out of range, no room of that number.
+ */ 
+static void cmd_print_room(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    // get room based on valid room number
+    Room& room = find_room(meeting_data.rooms, room_number);
+    meeting_data.os << room;
+}
+
+/*
+ * Performs error checks on integer pointed to by the argument.
+ * The input data is first checked for whether it is an integer,
+ * and if it is, whether it is in the valid range for a time.
+ * Returns 1 if there are no errors and returns 0 if an error occured.
+ */ 
+int get_and_check_meeting_time(istream& is)
+{
+    int time = read_and_check_cmd_int(is);
+
+    if(!is_meeting_time(time))
+    {
+        throw Error(bad_time_range_message_c);
+    }
+    return time;
+}
+
+/*
+ * Called when a user of the program types in the 'pm' command.
+ * Prints the time, topic, and participants for a specified meeting.
+ * Errors: room number out of range, no room of that number, time out
+ * of range, no meeting at that time.
+ */ 
+static void cmd_print_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+    int time = get_and_check_meeting_time(meeting_data.is);
+    
+    // get_Meeting checks for presence of meeting.
+    const Meeting* meeting = room.get_Meeting(time);
+    assert(meeting);
+    meeting_data.os << *meeting;
+}
+
+string read_rest_of_line(istream& is)
+{
+    string line;
+    while (is.peek() != '\n' && is.peek() != EOF)
+    {
+        line += is.get();
+    }
+    return line;
+}
+
+// skips spaces and tabs, but not the end of the line.
+static void skip_blanks(istream& is)
+{
+    while (is.peek() == ' ' || is.peek() == '\t')
+    {
+        is.get();
+    }
+}
+
+bool read_page_arguments(istream& is, int& limit, string& cursor)
+{
+    // the arguments are optional, and another command may follow on the
+    // same line, so they are only read if a limit follows.
+    skip_blanks(is);
+    if (!isdigit(is.peek()))
+    {
+        return false;
+    }
+    limit = read_and_check_cmd_int(is);
+    if (limit <= 0)
+    {
+        throw Error(bad_page_limit_message_c);
+    }
+    skip_blanks(is);
+    if (is.peek() != '\n' && is.peek() != EOF)
+    {
+        is >> cursor;
+    }
+    return true;
+}
+
+void parse_room_cursor(const string& cursor, int& room_number, int& time)
+{
+    istringstream cursor_is(cursor);
+    char separator;
+    cursor_is >> room_number >> separator >> time;
+    if (!cursor_is || separator != '.' || !cursor_is.eof())
+    {
+        throw Error(bad_cursor_message_c);
+    }
+}
+
+/*
+ * Prints one page of the 'ps' listing: at most limit rows, each of which is a
+ * meeting or an empty room, starting after the row named by the cursor.
+ * A room's heading is printed again if its meetings continue on a new page.
+ * Ends with the cursor of the last row if there are more rows.
+ */
+static void print_meetings_page(MeetingData& meeting_data, int limit, const string& cursor)
+{
+    int cursor_room = 0, cursor_time = 0;
+    if (!cursor.empty())
+    {
+        parse_room_cursor(cursor, cursor_room, cursor_time);
+    }
+    print_list_heading(meeting_data.os, meeting_data.rooms.size(), "rooms");
+
+    int rows = 0, last_room = 0, last_time = 0;
+    bool more = false;
+    for (auto room_it = meeting_data.rooms.lower_bound(cursor_room);
+            room_it != meeting_data.rooms.end() && !more; ++room_it)
+    {
+        int room_number = room_it->get_room_number();
+        // the cursor's room continues after the cursor's row.
+        bool resumed = !cursor.empty() && room_number == cursor_room;
+        if (!room_it->has_Meetings())
+        {
+            if (resumed)
+            {
+                continue;
+            }
+            if (rows == limit)
+            {
+                more = true;
+                break;
+            }
+            meeting_data.os << *room_it;
+            ++rows;
+            last_room = room_number;
+            last_time = 0;
+            continue;
+        }
+        bool heading_printed = false;
+        room_it->for_each_Meeting_after(resumed ? cursor_time : 0,
+                [&meeting_data, limit, room_number, &rows, &more, &heading_printed, &last_room, &last_time]
+                (const Meeting* meeting)
+                {
+                    if (rows == limit)
+                    {
+                        more = true;
+                        return false;
+                    }
+                    if (!heading_printed)
+                    {
+                        print_room_heading(meeting_data.os, room_number);
+                        heading_printed = true;
+                    }
+                    meeting_data.os << *meeting;
+                    ++rows;
+                    last_room = room_number;
+                    last_time = meeting->get_time();
+                    return true;
+                });
+    }
+    if (more)
+    {
+        print_page_cursor(meeting_data.os, last_room, last_time);
+    }
+}
+
+/*
+ * Called when a user of the program types in the 'ps' command.
+ * Prints the meeting information for all meetings in a room,
+ * or one page of it if a limit and optional cursor are given.
+ * Errors: limit is not a positive integer, invalid cursor.
+ */ 
+static void cmd_print_all_meetings(MeetingData& meeting_data)
+{
+    int limit;
+    string cursor;
+    if (read_page_arguments(meeting_data.is, limit, cursor))
+    {
+        print_meetings_page(meeting_data, limit, cursor);
+        return;
+    }
+    if (meeting_data.rooms.empty())
+    {
+        print_empty_list(meeting_data.os, "rooms");
+        return;
+    }
+    else
+    {
+        print_list_heading(meeting_data.os, meeting_data.rooms.size(), "rooms");
+        /* Prints room information for each room. */
+        /**** the one range for ***/
+        for(const auto& room : meeting_data.rooms)
+        {
+            meeting_data.os << room;
+        }
+    }
+}
+
+/*
+ * Prints one page of the 'pg' listing: at most limit people, starting after
+ * the last name given as the cursor. Ends with the cursor of the last person
+ * printed if there are more people.
+ */
+static void print_people_page(MeetingData& meeting_data, int limit, const string& cursor)
+{
+    print_list_heading(meeting_data.os, meeting_data.people.size(), "people");
+    auto person_it = cursor.empty() ? meeting_data.people.begin() : meeting_data.people.upper_bound(cursor);
+    for (int rows = 0; person_it != meeting_data.people.end() && rows < limit; ++person_it, ++rows)
+    {
+        meeting_data.os << **person_it << endl;
+    }
+    if (person_it != meeting_data.people.end())
+    {
+        print_page_cursor(meeting_data.os, (*prev(person_it))->get_lastname());
+    }
+}
+
+/*
+ * Called when a user of the program types in the 'pg' command.
+ * Prints the individual information for all people in the person list,
+ * or one page of it if a limit and optional cursor are given.
+ * Errors: limit is not a positive integer.
+ */ 
+static void cmd_print_all_people(MeetingData& meeting_data)
+{
+    int limit;
+    string cursor;
+    if (read_page_arguments(meeting_data.is, limit, cursor))
+    {
+        print_people_page(meeting_data, limit, cursor);
+        return;
+    }
+    if (meeting_data.people.empty())
+    {
+        print_empty_list(meeting_data.os, "people");
+    }
+    else
+    {
+        print_list_heading(meeting_data.os, meeting_data.people.size(), "people");
+        // prints information for each person in the people list.
+        for_each(meeting_data.people.begin(), meeting_data.people.end(), 
+                [&meeting_data](const Person* person){ meeting_data.os << *person << endl;});
+    }
+}
+
+/*
+ * Called when a user of the program types in the 'pa' command.
+ * Prints all memory allocations.
+ * Errors: None.
+ */ 
+static void cmd_print_allocated(MeetingData& meeting_data)
+{
+    meeting_data.os << "Memory allocations:" << endl;
+    meeting_data.os << "Persons: " << meeting_data.people.size() << endl;
+    // creates a functor that we use to get the sum of the meeting from.
+    // each room's number of meetings is added to the function object
+    Calc_Sum_Meetings cs = for_each(meeting_data.rooms.begin(), meeting_data.rooms.end(), Calc_Sum_Meetings());
+    meeting_data.os << "Meetings: " << cs.get_sum() << endl;
+    meeting_data.os << "Rooms: " << meeting_data.rooms.size() << endl;
+    if (meeting_data.published)
+    {
+        meeting_data.published->print_versions(meeting_data.os);
+    }
+}
+
+/*
+ * Called when a user types in the 'ai' command.
+ * Adds an individual person to the people list.
+ * Errors: Person with last name already in people list.
+ */
+static void cmd_add_individual(MeetingData& meeting_data)
+{
+    string firstname, lastname, phoneno;
+    /* read all 3 last names before testing validity */
+    meeting_data.is >> firstname >> lastname >> phoneno;
+
+    if (meeting_data.people.find(lastname))
+    {
+        throw Error("There is already a person with this last name!");
+    }
+
+    // if throw, main catches bad alloc.
+    Person* person = new Person(firstname, lastname, phoneno);
+    meeting_data.people.insert(person);
+    record_person_change(lastname);
+    meeting_data.os << "Person " << lastname << " added" << endl;
+}
+
+/*
+ * Called when a user types the 'ar' command.
+ * Adds a room with the specified number and, if they follow, the number of
+ * seats and the attributes it has.
+ * Errors: Room number out of range, number of seats not an integer or
+ * negative, unknown attribute, room of that number already exists.
+ */
+static void cmd_add_room(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    // the capacity and attributes are optional, and only read if a number
+    // follows on the same line.
+    int capacity = 0;
+    unsigned int attributes = 0;
+    skip_blanks(meeting_data.is);
+    if (isdigit(meeting_data.is.peek()))
+    {
+        read_room_features(meeting_data.is, capacity, attributes);
+    }
+    
+    if (meeting_data.rooms.find(room_number))
+    {
+        throw Error("There is already a room with this number!");
+    }
+    meeting_data.rooms.insert(Room(room_number, capacity, attributes));
+    record_room_change(room_number);
+    meeting_data.os << "Room " << room_number << " added" << endl;
+}
+
+/*
+ * Called when a user types the 'rc' command.
+ * Gives a room the number of seats and the attributes named after it,
+ * replacing those it had.
+ * Errors: room number out of range, no room of that number, number not
+ * an integer or negative, unknown attribute.
+ */
+static void cmd_set_room_capacity(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+    int capacity;
+    unsigned int attributes;
+    read_room_features(meeting_data.is, capacity, attributes);
+    meeting_data.rooms.set_room_features(room, capacity, attributes);
+    record_room_change(room_number);
+    meeting_data.os << "Room " << room_number << " has capacity " << capacity << ", attributes:";
+    if (attributes)
+    {
+        print_room_attributes(meeting_data.os, attributes);
+    }
+    else
+    {
+        meeting_data.os << " none";
+    }
+    meeting_data.os << endl;
+}
+
+/*
+ * Called when a user types the 'am' command.
+ * Adds a meeting in a specified room, at a specified time, and
+ * on a specified topic; with the near option, in the nearest free room
+ * and time if that one is taken (see Slot_finder.h).
+ * Errors: room number out of range, no room of that number, time
+ * out of range, no meeting at that time, no person in people list of
+ * that name, there is already a participant of that name.
+ */
+static void cmd_add_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room* room = &find_room(meeting_data.rooms, room_number);
+
+    int time = get_and_check_meeting_time(meeting_data.is);
+
+    string topic;
+    meeting_data.is >> topic;
+
+    // with the near option, a taken room and time is replaced by the nearest free one.
+    int count;
+    bool moved = false;
+    if (read_nearest_option(meeting_data.is, count) &&
+            room->has_Meeting_conflict(time_minute(time), time_minute(time) + minutes_per_slot_c))
+    {
+        vector<Room_time> nearest = find_nearest_slots(meeting_data.rooms, room_number, time, nullptr, max(count, 1));
+        if (count && !nearest.empty())
+        {
+            print_nearest_slots(meeting_data.os, nearest);
+            return;
+        }
+        if (!nearest.empty())
+        {
+            room_number = nearest.front().room_number;
+            time = nearest.front().time;
+            room = &find_room(meeting_data.rooms, room_number);
+            moved = true;
+        }
+    }
+    
+    Meeting* meeting = new Meeting(time, topic);
+
+    /* add handles duplicate meeting error. */
+    try{
+        room->add_Meeting(meeting);
+    }
+    catch(...)
+    {
+        delete meeting;
+        throw;
+    }
+    if (moved)
+    {
+        meeting_data.os << "Meeting added in room " << room_number << " at " << time << endl;
+    }
+    else
+    {
+        meeting_data.os << "Meeting added at " << time << endl;
+    }
+}
+
+// Prints the room and time of each of the nearest free slots, one to a line.
+static void print_nearest_slots(ostream& os, const vector<Room_time>& nearest)
+{
+    os << "Nearest free slots: " << nearest.size() << endl;
+    for (const Room_time& room_time : nearest)
+    {
+        os << "Room " << room_time.room_number << " at " << room_time.time << endl;
+    }
+}
+
+/*
+ * Called when a user types the 'at' command.
+ * Adds a meeting that starts and ends at the quarter hours given as
+ * h:mm-h:mm, such as 9:30-11:00, or that fills the hour given as h, as am does.
+ * The meeting is named by the hour it starts in by the other commands.
+ * Errors: room number out of range, no room of that number, the time is
+ * not a time span within the meeting times, the meeting would overlap
+ * another or start in the same hour as another.
+ */
+static void cmd_add_timed_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+
+    string time_text;
+    int start, duration;
+    meeting_data.is >> time_text;
+    if (!parse_time_span(time_text, start, duration))
+    {
+        throw Error(bad_time_range_message_c);
+    }
+
+    string topic;
+    meeting_data.is >> topic;
+
+    Meeting* meeting = new Meeting(start, duration, topic);
+
+    /* add handles the overlapping meeting error. */
+    try{
+        room.add_Meeting(meeting);
+    }
+    catch(...)
+    {
+        delete meeting;
+        throw;
+    }
+    meeting_data.os << "Meeting added at ";
+    print_time_span(meeting_data.os, start, duration);
+    meeting_data.os << endl;
+}
+
+/*
+ * Called when a user types the 'ap' command.
+ * Adds a specified person as a participant in a specified meeting.
+ * Errors: Room number out of range, no room of that number, time out of range,
+ * no meeting at time, no person in people list of that name,
+ * participant already exists for that time.
+ */
+static void cmd_add_participant(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+
+    Room& room = find_room(meeting_data.rooms, room_number);
+
+    int time = get_and_check_meeting_time(meeting_data.is);
+    /* check meeting exists */
+    if (!room.is_Meeting_present(time))
+    {
+        throw Error(no_meeting_at_time_message_c);
+    }
+    Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+
+    room.add_Meeting_participant(time, person);
+    
+    meeting_data.os << "Participant " << person->get_lastname() << " added" << endl;
+}
+
+/*
+ * Called when user types the 'rm' command.
+ * Reschedules a meeting by changing its room and/or time
+ * without changing or reentering topic or participants. A meeting that
+ * starts past the hour keeps its minutes past the hour and its duration.
+ * With the near option, a taken room and time is replaced by the nearest
+ * free one (see Slot_finder.h).
+ */
+static void cmd_reschedule_meeting(MeetingData& meeting_data)
+{
+    int old_room_number = get_and_check_room_number(meeting_data.is);
+    Room& old_room = find_room(meeting_data.rooms, old_room_number);
+
+    int old_meeting_time = get_and_check_meeting_time(meeting_data.is);
+    // also checks whether meeting is present.
+    const Meeting* old_room_meeting = old_room.get_Meeting(old_meeting_time);
+    assert(old_room_meeting);
+
+    int new_room_number = get_and_check_room_number(meeting_data.is);
+    Room* new_room = &find_room(meeting_data.rooms, new_room_number);
+
+    int new_meeting_time = get_and_check_meeting_time(meeting_data.is);
+    int count;
+    bool nearest_option = read_nearest_option(meeting_data.is, count);
+    // rescheduling to the same room and time, print message and return.
+    if (old_meeting_time == new_meeting_time && old_room_number == new_room_number)
+    {
+        meeting_data.os << no_change_message_c << endl;
+        return;
+    }
+
+    // the meeting keeps its minutes past the hour and its duration, so it must
+    // still end by the end of the day.
+    int new_start = time_minute(new_meeting_time) + old_room_meeting->get_start() % minutes_per_slot_c;
+    int new_end = new_start + old_room_meeting->get_duration();
+    if (new_end > minutes_per_day_c)
+    {
+        throw Error(bad_time_range_message_c);
+    }
+
+    // with the near option, a taken room and time is replaced by the nearest free
+    // one; if there is none, the checks below report why it is taken.
+    if (nearest_option && (new_room->has_Meeting_conflict(new_start, new_end, old_room_meeting) ||
+                old_room_meeting->has_participant_commitment_conflict(new_meeting_time)))
+    {
+        vector<Room_time> nearest = find_nearest_slots(meeting_data.rooms, new_room_number, new_meeting_time,
+                old_room_meeting, max(count, 1));
+        if (count && !nearest.empty())
+        {
+            print_nearest_slots(meeting_data.os, nearest);
+            return;
+        }
+        if (!nearest.empty())
+        {
+            new_room_number = nearest.front().room_number;
+            new_meeting_time = nearest.front().time;
+            new_room = &find_room(meeting_data.rooms, new_room_number);
+            new_start = time_minute(new_meeting_time) + old_room_meeting->get_start() % minutes_per_slot_c;
+            new_end = new_start + old_room_meeting->get_duration();
+        }
+    }
+
+    //check that new time is available for meeting in new room.
+    if (new_room->has_Meeting_conflict(new_start, new_end, old_room_meeting))
+    {
+        throw Error(meeting_exists_at_time_message_c);
+    }
+
+    // check for participant conflicts
+    if (old_room_meeting->has_participant_commitment_conflict(new_meeting_time))
+    {
+        throw Error(participant_committed_at_new_time_message_c);
+    }
+
+    // remove the participants' commitments to the meeting before it moves.
+    old_room_meeting->remove_participant_commitments(old_room_number);
+
+    Meeting* meeting_to_reschedule = old_room.remove_Meeting(old_meeting_time);
+    assert(meeting_to_reschedule);
+    meeting_to_reschedule->set_time(new_meeting_time);
+    new_room->add_Meeting(meeting_to_reschedule);
+
+    // commit the participants to the meeting at its new room and time.
+    meeting_to_reschedule->add_participant_commitments(new_room_number);
+
+    meeting_data.os << "Meeting rescheduled to room " << new_room_number << " at " << new_meeting_time << endl;
+}
+
+/*
+ * Called when the user types a 'di' command.
+ * Delets a person from the people list, but only if the person is not
+ * a participant in the meeting.
+ * Errors: No person of that name or person is a participant in a meeting.
+ *
+ */
+static void cmd_delete_individual(MeetingData& meeting_data)
+{
+    Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+    
+    // a person's commitments are exactly the meetings they are a participant in.
+    if(person->has_commitments())
+    {
+        throw Error(person_is_participant_message_c);
+    }
+
+    meeting_data.os << "Person " << person->get_lastname() << " deleted" << endl;
+    meeting_data.people.erase(person);
+    record_person_deletion(person->get_lastname());
+    delete person;
+}
+
+/*
+ * Called when the user types a 'dr' command.
+ * Deletes the room with the specified number, including
+ * all meetings scheduled in the room.
+ * Errors: room number out of range, no room of that number.
+ */
+static void cmd_delete_room(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+
+    /* check if room exists. */
+    Room& room = find_room(meeting_data.rooms, room_number);
+    // only the participants of the room's meetings have commitments in it.
+    room.remove_participant_commitments();
+    // need to clear meetings in a room to free pointers
+    room.clear_Meetings();
+    meeting_data.rooms.erase(room_number);
+    record_room_deletion(room_number);
+    meeting_data.os << "Room " << room_number << " deleted" << endl;
+}
+
+/*
+ * Called when the user types a 'dm' command.
+ * Deletes a meeting.
+ * Errors: room number out of range, no room of that number,
+ * time out of range, no meeting at that time.
+ */
+static void cmd_delete_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+
+    int time = get_and_check_meeting_time(meeting_data.is);
+
+    Meeting* removed_meeting = room.remove_Meeting(time);
+    assert(removed_meeting);
+
+    // removes commitments to this meeting for its participants.
+    removed_meeting->remove_participant_commitments(room_number);
+
+    delete removed_meeting;
+    meeting_data.os << "Meeting at " << time << " deleted" << endl;
+}
+
+/*
+ * Called when the user types a 'dp' command.
+ * Delete a specified person from the participant list for a specified meeting.
+ * Errors: room num out of range, no room of the num, time out of range,
+ * no meeting at time, no person of that name in people list,
+ * no person of name in participant list.
+ */
+static void cmd_delete_participant(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+
+    /*check room exists */
+    Room& room = find_room(meeting_data.rooms, room_number);
+    int time = get_and_check_meeting_time(meeting_data.is);
+
+    /* check meeting exists */
+    if (!room.is_Meeting_present(time))
+    {
+        throw Error(no_meeting_at_time_message_c);
+    }
+    Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    assert(person);
+    room.remove_Meeting_participant(time, person);
+    meeting_data.os << "Participant " << person->get_lastname() << " deleted" << endl;
+}
+
+/*
+ * Called when the user enters a 'ds' command.
+ * Delete all meetings from all room.
+ * Errors: None.
+ */
+static void cmd_delete_schedule(MeetingData& meeting_data)
+{
+    /* clear all the meeting_data.rooms in the container */
+    for_each(meeting_data.rooms.begin(), meeting_data.rooms.end(), mem_fn(&Room::clear_Meetings));
+    for_each(meeting_data.people.begin(), meeting_data.people.end(), mem_fn(&Person::clear_Commitments));
+    meeting_data.os << all_meetings_deleted_message_c << endl;
+}
+
+/*
+ * Function that deletes people pointers and clears the people list.
+ */
+static void clear_people_list(People_t& people)
+{
+    for_each(people.begin(), people.end(), 
+            [](const Person* person){ record_person_deletion(person->get_lastname()); delete person; });
+    people.clear();
+}
+
+/*
+ * Called when the user enters a 'dg' command.
+ * Deletes all of the individual information, but only if
+ * there are no meetings scheduled.
+ * Errors: There are scheduled meetings.
+ */
+static void cmd_delete_all_individuals(MeetingData& meeting_data)
+{
+    /* for each room, look at each meeting's size */
+    if (any_of(meeting_data.rooms.begin(), meeting_data.rooms.end(),
+            [](const Room& room){ return room.has_Meetings() || room.has_Dated_meetings(); }))
+    {
+        meeting_data.os << "Cannot clear people list unless there are no meetings!" << endl;
+    }
+    else
+    {
+        clear_people_list(meeting_data.people);
+        meeting_data.os << all_persons_deleted_message_c << endl;
+    }
+}
+
+/*
+ *  Helper function that deletes the meeting pointers in rooms
+ *  and clear the room list.
+ */
+static void clear_room_list(Room_t& rooms)
+{
+    /* Delete all meetings in rooms */
+    for_each(rooms.begin(), rooms.end(), mem_fn(&Room::clear_Meetings));
+    for_each(rooms.begin(), rooms.end(),
+            [](const Room& room){ record_room_deletion(room.get_room_number()); });
+    rooms.clear();   
+}
+
+/*
+ * Called when the user enters the 'da' command.
+ * Deletes all the rooms and their meetings and then
+ * deletes all persons in the people list.
+ * Errors: None.
+ */
+static void cmd_delete_all(MeetingData& meeting_data)
+{
+    clear_schedule(meeting_data);
+    meeting_data.os << "All rooms and meetings deleted" << endl;
+    meeting_data.os << all_persons_deleted_message_c << endl; 
+}
+
+void clear_schedule(MeetingData& meeting_data)
+{
+    clear_room_list(meeting_data.rooms);
+    /* delete all individuals */
+    clear_people_list(meeting_data.people);
+}
+
+/*
+ * Called when a user enters a 'sd' command.
+ * Saves data by writing the people, rooms, and meetings
+ * data to the named file.
+ * Error: File cannot be opened for output.
+ */
+static void cmd_save_data(MeetingData& meeting_data)
+{
+    string filename;
+    meeting_data.is >> filename;
+
+    ofstream outfile(filename.c_str());
+    if(!outfile)
+    {
+        throw Error(file_cannot_open_message_c);
+    }
+    
+    outfile << meeting_data.people.size() << endl;
+    // save the data for each person into outfile
+    for_each(meeting_data.people.begin(), meeting_data.people.end(), 
+            bind(&Person::save, placeholders::_1, ref(outfile)));
+
+    outfile << meeting_data.rooms.size() << endl;
+    // save the data for each room into outfile
+    for_each(meeting_data.rooms.begin(), meeting_data.rooms.end(),
+        bind(&Room::save, placeholders::_1, ref(outfile)));
+
+    meeting_data.os << "Data saved" << endl;
+    outfile.close();
+}
+
+/*
+ * Records a change to every room and person in the change feed.
+ */
+static void record_schedule_changes(const Room_t& rooms, const People_t& people)
+{
+    for_each(rooms.begin(), rooms.end(),
+            [](const Room& room){ record_room_change(room.get_room_number()); });
+    for_each(people.begin(), people.end(),
+            [](const Person* person){ record_person_change(person->get_lastname()); });
+}
+
+/*
+ * Roll back backed up data in the case of a failed load 
+ * Function takes in four arguments: the current room and people's
+ * lists and the backup room and backup people's lists.
+ */
+static void roll_back(Room_t& rooms, People_t& people, Room_t& rooms_backup, People_t& people_backup, ifstream& is)
+{
+    // clear and release resources for room and people containers
+    clear_room_list(rooms);
+    clear_people_list(people);
+    // swap the backups back in to restore state
+    people.swap(people_backup);
+    rooms.swap(rooms_backup);
+    // the restored rooms and people may share a number or name with one just
+    // deleted, so the change feed learns their versions again.
+    record_schedule_changes(rooms, people);
+    // close the file after a roll-back.
+    is.close();
+}
+
+/*
+ * Called when a user types an 'ld' command.
+ * Restores the program state from the data in the file.
+ * Errors: File cannot be opened for input, invalid data found in file.
+ */
+static void cmd_load_data(MeetingData& meeting_data)
+{
+    string filename;
+    meeting_data.is >> filename;
+
+    ifstream infile(filename.c_str());
+    if(!infile)
+    {
+        infile.close();
+        throw Error(file_cannot_open_message_c);
+    }
+    
+    int num_people;
+    infile >> num_people;
+    // close file
+    try
+    {
+        file_invalid_data_check(infile);
+    }
+    catch(Error& e)
+    {
+        infile.close();
+        throw;
+    }
+    
+    /* 
+     * Backups: the current rooms and people are swapped out, leaving
+     * the room and people lists empty, without copying any of them.
+     */ 
+    Room_t rooms_backup;
+    People_t people_backup;
+    rooms_backup.swap(meeting_data.rooms);
+    people_backup.swap(meeting_data.people);
+
+    while (num_people-- > 0)
+    {
+        Person* person_to_load;
+        try{
+            person_to_load = new Person(infile);
+        }
+        // different possible exceptions thrown
+        catch (...)
+        {
+            // roll_back closes file
+            roll_back(meeting_data.rooms, meeting_data.people, rooms_backup, people_backup, infile);
+            throw;
+        }
+        // the file may not have two people with the same last name.
+        if (!meeting_data.people.insert(person_to_load))
+        {
+            delete person_to_load;
+            roll_back(meeting_data.rooms, meeting_data.people, rooms_backup, people_backup, infile);
+            throw Error(invalid_file_data_message_c);
+        }
+    }
+
+    int num_rooms;
+    infile >> num_rooms;
+    try
+    {
+        file_invalid_data_check(infile);
+    }
+    catch(Error& e)
+    {
+        roll_back(meeting_data.rooms, meeting_data.people, rooms_backup, people_backup, infile);
+        throw;
+    }
+
+    while (num_rooms-- > 0)
+    {
+        try{
+            Room room_to_load(infile, meeting_data.people);
+            // the file may not have two rooms with the same number.
+            if (meeting_data.rooms.find(room_to_load.get_room_number()))
+            {
+                room_to_load.clear_Meetings();
+                throw Error(invalid_file_data_message_c);
+            }
+            meeting_data.rooms.insert(move(room_to_load));
+        }
+        // different possible exceptions thrown
+        catch (...)
+        {
+            roll_back(meeting_data.rooms, meeting_data.people, rooms_backup, people_backup, infile);
+            throw;
+        }
+    }
+    /* get rid of backup data */
+    clear_room_list(rooms_backup);
+    clear_people_list(people_backup);
+    /* everything loaded is new to the change feed */
+    record_schedule_changes(meeting_data.rooms, meeting_data.people);
+
+    meeting_data.os << "Data loaded" << endl;
+    infile.close();
+}
+
+/*
+ *  Function that handles the "qq" command.
+ *  Deletes all allocated memory and prints Done.
+ */
+void cmd_quit(MeetingData& meeting_data)
+{
+    cmd_delete_all(meeting_data);
+    meeting_data.os << "Done" << endl;
+}
+
+static Change_feed& get_change_feed(MeetingData& meeting_data)
+{
+    if (!meeting_data.feed)
+    {
+        throw Error(no_change_feed_message_c);
+    }
+    return *meeting_data.feed;
+}
+
+/*
+ * Reads the optional version a subscription starts after, which must be on the
+ * same line and start with a digit. Without it, a subscription starts after
+ * the current version, that of the command itself.
+ */
+static uint64_t read_since_version(MeetingData& meeting_data)
+{
+    skip_blanks(meeting_data.is);
+    if (!isdigit(meeting_data.is.peek()))
+    {
+        return get_change_feed(meeting_data).get_version();
+    }
+    return read_and_check_cmd_int(meeting_data.is);
+}
+
+/*
+ * Called when the user types a 'wr' command.
+ * Subscribes to the changes to the rooms in a range of room numbers,
+ * made after the optional version, and prints the subscription number.
+ * Errors: room numbers out of range, first room number after the last.
+ */
+static void cmd_watch_rooms(MeetingData& meeting_data)
+{
+    Change_feed& feed = get_change_feed(meeting_data);
+    int first_room = get_and_check_room_number(meeting_data.is);
+    int last_room = get_and_check_room_number(meeting_data.is);
+    if (first_room > last_room)
+    {
+        throw Error(bad_room_range_message_c);
+    }
+    uint64_t since = read_since_version(meeting_data);
+    int subscription = feed.watch_rooms(first_room, last_room, since);
+    meeting_data.os << "Subscription " << subscription << " watches rooms " << first_room
+        << " to " << last_room << " after version " << since << endl;
+}
+
+/*
+ * Called when the user types a 'wp' command.
+ * Subscribes to the changes to all people made after the optional version,
+ * and prints the subscription number.
+ * Errors: None.
+ */
+static void cmd_watch_people(MeetingData& meeting_data)
+{
+    Change_feed& feed = get_change_feed(meeting_data);
+    uint64_t since = read_since_version(meeting_data);
+    int subscription = feed.watch_people(since);
+    meeting_data.os << "Subscription " << subscription << " watches people after version " << since << endl;
+}
+
+/*
+ * Called when the user types a 'wc' command.
+ * Prints the changes a subscription has not delivered yet, each changed
+ * room or person once with the version of its latest change.
+ * Errors: no subscription of that number.
+ */
+static void cmd_watch_changes(MeetingData& meeting_data)
+{
+    Change_feed& feed = get_change_feed(meeting_data);
+    feed.print_changes(read_and_check_cmd_int(meeting_data.is), meeting_data.os);
+}
+
+/*
+ * Called when the user types a 'wu' command.
+ * Cancels a subscription.
+ * Errors: no subscription of that number.
+ */
+static void cmd_watch_cancel(MeetingData& meeting_data)
+{
+    Change_feed& feed = get_change_feed(meeting_data);
+    int subscription = read_and_check_cmd_int(meeting_data.is);
+    feed.cancel(subscription);
+    meeting_data.os << "Subscription " << subscription << " cancelled" << endl;
+}
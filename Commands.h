@@ -0,0 +1,94 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include "Utility.h"
+#include "People_directory.h"
+#include "Room_directory.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* The command functions that operate on one schedule (a set of rooms and people).
+Each command reads its arguments from the schedule's input stream and writes its
+results to the schedule's output stream, so the same commands serve the interactive
+loop as well as schedules hosted on a shard worker thread. Commands throw Error
+exceptions for user errors; the caller is responsible for reporting them. */
+
+// alias for the directory of rooms
+using Room_t = Room_directory;
+
+class Change_feed;
+class Published_schedule;
+
+/*
+ * struct containing variables needed by command functions.
+ * used as a short-hand to move all variables at once.
+ */
+struct MeetingData
+{
+    Room_t& rooms;
+    People_t& people;
+    std::istream& is;
+    std::ostream& os;
+    // the published copy of the schedule, if it has one
+    const Published_schedule* published;
+    // the feed the schedule's changes are recorded in, if it has one
+    Change_feed* feed;
+
+    MeetingData(Room_t& rooms_, People_t& people_,
+            std::istream& is_ = std::cin, std::ostream& os_ = std::cout,
+            const Published_schedule* published_ = nullptr, Change_feed* feed_ = nullptr)
+        : rooms(rooms_), people(people_), is(is_), os(os_), published(published_), feed(feed_) {}
+};
+
+// pointer to a command function
+using Command_func_t = void(*)(MeetingData&);
+
+// Returns the function for the two-letter command name,
+// or nullptr if there is no such command.
+Command_func_t find_command(const std::string& cmd);
+
+// Reads a two-letter command name from the input stream, skipping whitespace.
+std::string read_command_name(std::istream& is);
+
+// Reads and runs one command from the schedule's input stream.
+// Error exceptions are caught and their message written to the output stream;
+// other exceptions are propagated. Returns false if the command failed.
+bool execute_command(MeetingData& meeting_data);
+
+// Reads an integer; throws Error if the input is not an integer.
+int read_and_check_cmd_int(std::istream& is);
+
+// Reads a room number and checks that it is in range; throws Error if not.
+int get_and_check_room_number(std::istream& is);
+
+// Reads a meeting time and checks that it is in range; throws Error if not.
+int get_and_check_meeting_time(std::istream& is);
+
+// Returns the room of the number; throws Error if there is none.
+Room& find_room(Room_t& rooms, int room_number);
+
+// Reads a last name and returns the person of that name; throws Error if there is none.
+Person* find_and_get_person(std::istream& is, People_t& people);
+
+// Reads the rest of the line from the input stream, leaving the newline in it
+// to be skipped like the end of any other command.
+std::string read_rest_of_line(std::istream& is);
+
+// Reads the optional page arguments "limit [cursor]" of ps and pg, which must be
+// on the same line and start with a digit. Returns false if there are none, so
+// that everything is printed. Throws Error if the limit is not positive.
+bool read_page_arguments(std::istream& is, int& limit, std::string& cursor);
+
+// Splits a ps cursor, which names the last room and meeting time printed
+// (zero for an empty room), into its parts. Throws Error if it is invalid.
+void parse_room_cursor(const std::string& cursor, int& room_number, int& time);
+
+// Function that handles the "qq" command.
+// Deletes all allocated memory and prints Done.
+void cmd_quit(MeetingData& meeting_data);
+
+// Deletes all rooms, meetings and people of the schedule.
+void clear_schedule(MeetingData& meeting_data);
+
+#endif
@@ -0,0 +1,284 @@
+#include "Dated_commands.h"
+#include "Dated_meeting.h"
+#include "Person.h"
+#include <cassert>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+// string literals
+const char* const bad_date_message_c = "Date is not valid!";
+const char* const bad_date_range_message_c = "Last date is before first date!";
+const char* const bad_period_message_c = "Period must be positive!";
+
+static int read_date(istream& is)
+{
+    string text;
+    int date;
+    is >> text;
+    if (!parse_date(text, date))
+    {
+        throw Error(bad_date_message_c);
+    }
+    return date;
+}
+
+static void read_time_span(istream& is, int& start, int& duration)
+{
+    string text;
+    is >> text;
+    if (!parse_time_span(text, start, duration))
+    {
+        throw Error(bad_time_range_message_c);
+    }
+}
+
+// reads a first and last date, which may not be before the first.
+static void read_date_range(istream& is, int& first_date, int& last_date)
+{
+    first_date = read_date(is);
+    last_date = read_date(is);
+    if (last_date < first_date)
+    {
+        throw Error(bad_date_range_message_c);
+    }
+}
+
+// adds the meeting to the room, deleting it if it cannot be added.
+static void add_to_room(Room& room, Dated_meeting* meeting)
+{
+    try{
+        room.add_Dated_meeting(meeting);
+    }
+    catch(...)
+    {
+        delete meeting;
+        throw;
+    }
+}
+
+void cmd_add_dated_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+    int date = read_date(meeting_data.is);
+    int start, duration;
+    read_time_span(meeting_data.is, start, duration);
+    string topic;
+    meeting_data.is >> topic;
+
+    add_to_room(room, new Dated_meeting(room_number, date, date, 1, start, duration, topic));
+    meeting_data.os << "Meeting added on ";
+    print_date(meeting_data.os, date);
+    meeting_data.os << " at ";
+    print_time_span(meeting_data.os, start, duration);
+    meeting_data.os << endl;
+}
+
+void cmd_add_repeating_meeting(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    Room& room = find_room(meeting_data.rooms, room_number);
+    int first_date = read_date(meeting_data.is);
+    int start, duration;
+    read_time_span(meeting_data.is, start, duration);
+    int period = read_and_check_cmd_int(meeting_data.is);
+    if (period < 1)
+    {
+        throw Error(bad_period_message_c);
+    }
+    int last_date = read_date(meeting_data.is);
+    if (last_date < first_date)
+    {
+        throw Error(bad_date_range_message_c);
+    }
+    // the meeting ends on the last date it repeats on.
+    last_date -= (last_date - first_date) % period;
+    string topic;
+    meeting_data.is >> topic;
+
+    add_to_room(room, new Dated_meeting(room_number, first_date, last_date, period, start, duration, topic));
+    meeting_data.os << "Repeating meeting added from ";
+    print_date(meeting_data.os, first_date);
+    meeting_data.os << " to ";
+    print_date(meeting_data.os, last_date);
+    meeting_data.os << " at ";
+    print_time_span(meeting_data.os, start, duration);
+    meeting_data.os << endl;
+}
+
+void cmd_add_dated_participant(MeetingData& meeting_data)
+{
+    Room& room = find_room(meeting_data.rooms, get_and_check_room_number(meeting_data.is));
+    int date = read_date(meeting_data.is);
+    int time = get_and_check_meeting_time(meeting_data.is);
+    // check the meeting exists before the person.
+    room.get_Dated_meeting(date, time);
+    Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+
+    room.add_Dated_meeting_participant(date, time, person);
+    meeting_data.os << "Participant " << person->get_lastname() << " added" << endl;
+}
+
+void cmd_delete_dated_participant(MeetingData& meeting_data)
+{
+    Room& room = find_room(meeting_data.rooms, get_and_check_room_number(meeting_data.is));
+    int date = read_date(meeting_data.is);
+    int time = get_and_check_meeting_time(meeting_data.is);
+    room.get_Dated_meeting(date, time);
+    Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+
+    room.remove_Dated_meeting_participant(date, time, person);
+    meeting_data.os << "Participant " << person->get_lastname() << " deleted" << endl;
+}
+
+void cmd_delete_dated_meeting(MeetingData& meeting_data)
+{
+    Room& room = find_room(meeting_data.rooms, get_and_check_room_number(meeting_data.is));
+    int date = read_date(meeting_data.is);
+    int time = get_and_check_meeting_time(meeting_data.is);
+
+    Dated_meeting* removed_meeting = room.remove_Dated_meeting(date, time);
+    assert(removed_meeting);
+    removed_meeting->remove_participant_commitments();
+    if (removed_meeting->is_repeating())
+    {
+        meeting_data.os << "Repeating meeting from ";
+        print_date(meeting_data.os, removed_meeting->get_first_date());
+        meeting_data.os << " to ";
+        print_date(meeting_data.os, removed_meeting->get_last_date());
+    }
+    else
+    {
+        meeting_data.os << "Meeting on ";
+        print_date(meeting_data.os, date);
+        meeting_data.os << " at " << time;
+    }
+    meeting_data.os << " deleted" << endl;
+    delete removed_meeting;
+}
+
+void cmd_cancel_occurrence(MeetingData& meeting_data)
+{
+    Room& room = find_room(meeting_data.rooms, get_and_check_room_number(meeting_data.is));
+    int date = read_date(meeting_data.is);
+    int time = get_and_check_meeting_time(meeting_data.is);
+
+    room.cancel_Dated_occurrence(date, time);
+    meeting_data.os << "Meeting on ";
+    print_date(meeting_data.os, date);
+    meeting_data.os << " at " << time << " cancelled" << endl;
+}
+
+void cmd_reschedule_occurrence(MeetingData& meeting_data)
+{
+    Room& old_room = find_room(meeting_data.rooms, get_and_check_room_number(meeting_data.is));
+    int old_date = read_date(meeting_data.is);
+    int old_time = get_and_check_meeting_time(meeting_data.is);
+    const Dated_meeting* old_meeting = old_room.get_Dated_meeting(old_date, old_time);
+
+    int new_room_number = get_and_check_room_number(meeting_data.is);
+    Room& new_room = find_room(meeting_data.rooms, new_room_number);
+    int new_date = read_date(meeting_data.is);
+    int new_time = get_and_check_meeting_time(meeting_data.is);
+    if (&old_room == &new_room && old_date == new_date && old_time == new_time)
+    {
+        meeting_data.os << no_change_message_c << endl;
+        return;
+    }
+
+    // the occurrence keeps its minutes past the hour and its duration, so it must
+    // still end by the end of the day.
+    int new_start = time_minute(new_time) + old_meeting->get_start() % minutes_per_slot_c;
+    if (new_start + old_meeting->get_duration() > minutes_per_day_c)
+    {
+        throw Error(bad_time_range_message_c);
+    }
+    Dated_meeting* moved_meeting = new Dated_meeting(new_room_number, new_date, new_date, 1,
+            new_start, old_meeting->get_duration(), old_meeting->get_topic());
+    old_meeting->for_each_participant(bind(&Dated_meeting::add_participant, moved_meeting, placeholders::_1));
+
+    // a single meeting is checked as if it had moved; an occurrence of a repeating
+    // one is cancelled first, and restored if it cannot move.
+    const Dated_meeting* except = nullptr;
+    Dated_meeting* repeating_meeting = nullptr;
+    if (old_meeting->is_repeating())
+    {
+        repeating_meeting = old_room.cancel_Dated_occurrence(old_date, old_time);
+    }
+    else
+    {
+        except = old_meeting;
+    }
+    try{
+        if (new_room.has_Dated_meeting_conflict(*moved_meeting, except))
+        {
+            throw Error(meeting_exists_at_time_message_c);
+        }
+        if (moved_meeting->has_participant_commitment_conflict(except))
+        {
+            throw Error(participant_committed_at_new_time_message_c);
+        }
+    }
+    catch(...)
+    {
+        if (repeating_meeting)
+        {
+            old_room.restore_Dated_occurrence(old_date, repeating_meeting);
+        }
+        delete moved_meeting;
+        throw;
+    }
+
+    if (!repeating_meeting)
+    {
+        Dated_meeting* removed_meeting = old_room.remove_Dated_meeting(old_date, old_time);
+        removed_meeting->remove_participant_commitments();
+        delete removed_meeting;
+    }
+    new_room.add_Dated_meeting(moved_meeting);
+    moved_meeting->add_participant_commitments();
+
+    meeting_data.os << "Meeting rescheduled to room " << new_room_number << " on ";
+    print_date(meeting_data.os, new_date);
+    meeting_data.os << " at " << new_time << endl;
+}
+
+void cmd_print_room_dates(MeetingData& meeting_data)
+{
+    int room_number = get_and_check_room_number(meeting_data.is);
+    const Room& room = find_room(meeting_data.rooms, room_number);
+    int first_date, last_date;
+    read_date_range(meeting_data.is, first_date, last_date);
+
+    bool printed = false;
+    room.for_each_Dated_occurrence(first_date, last_date, [&meeting_data, &printed](int date, const Dated_meeting* meeting)
+            {
+                print_occurrence(meeting_data.os, date, meeting);
+                printed = true;
+            });
+    if (!printed)
+    {
+        print_no_meetings(meeting_data.os);
+    }
+}
+
+void cmd_print_person_dates(MeetingData& meeting_data)
+{
+    const Person* person = find_and_get_person(meeting_data.is, meeting_data.people);
+    int first_date, last_date;
+    read_date_range(meeting_data.is, first_date, last_date);
+
+    bool printed = false;
+    person->for_each_dated_commitment(first_date, last_date,
+            [&meeting_data, &printed](int date, const Dated_meeting* meeting)
+            {
+                print_occurrence(meeting_data.os, date, meeting);
+                printed = true;
+            });
+    if (!printed)
+    {
+        print_no_commitments(meeting_data.os);
+    }
+}
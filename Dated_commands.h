@@ -0,0 +1,46 @@
+#ifndef DATED_COMMANDS_H
+#define DATED_COMMANDS_H
+
+#include "Commands.h"
+
+/* The commands for meetings on dates, which are kept apart from the meetings of the
+day (see Dated_meeting and Horizon). Dates are written yyyy-mm-dd, a meeting's time
+span as at takes it (h, or h:mm-h:mm), and an occurrence is named by its room, its
+date and the hour it starts in, as the meetings of the day are named by the hour.
+
+    ad room date span topic                     add a meeting on a date
+    ac room date span period last_date topic    add a meeting repeating every period
+                                                days from the date up to last_date
+    ae room date time lastname                  add a participant to a meeting
+    de room date time lastname                  delete a participant from a meeting
+    dd room date time                           delete a meeting, every occurrence of
+                                                a repeating one included
+    dx room date time                           cancel one occurrence of a repeating meeting
+    rd room date time new_room new_date new_time
+                                                move one occurrence, keeping its minutes
+                                                past the hour and its duration
+    pd room first_date last_date                print a room's occurrences in a range
+    pe lastname first_date last_date            print a person's occurrences in a range
+
+A repeating meeting is stored once however many dates it occurs on, and a range is
+printed by working out each occurrence as it is reached, so a weekly meeting over a
+year costs no more to add, check or delete than one on a single date. Moving one
+occurrence of a repeating meeting cancels it there and adds a meeting on the new
+date with the same topic and participants.
+Errors: room number out of range, no room of that number, date not valid, time out
+of range, no meeting at that time, the meeting would conflict with another in the
+room or with a participant's commitments, no person of that name.
+*/
+
+// Functions that handle the commands.
+void cmd_add_dated_meeting(MeetingData& meeting_data);
+void cmd_add_repeating_meeting(MeetingData& meeting_data);
+void cmd_add_dated_participant(MeetingData& meeting_data);
+void cmd_delete_dated_participant(MeetingData& meeting_data);
+void cmd_delete_dated_meeting(MeetingData& meeting_data);
+void cmd_cancel_occurrence(MeetingData& meeting_data);
+void cmd_reschedule_occurrence(MeetingData& meeting_data);
+void cmd_print_room_dates(MeetingData& meeting_data);
+void cmd_print_person_dates(MeetingData& meeting_data);
+
+#endif
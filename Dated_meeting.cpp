@@ -0,0 +1,178 @@
+#include "Dated_meeting.h"
+#include "People_directory.h"
+#include "Person.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// returns the greatest common divisor of a and b, and x and y such that a * x + b * y is it.
+static int64_t extended_gcd(int64_t a, int64_t b, int64_t& x, int64_t& y)
+{
+    if (b == 0)
+    {
+        x = 1;
+        y = 0;
+        return a;
+    }
+    int64_t x1, y1;
+    int64_t gcd = extended_gcd(b, a % b, x1, y1);
+    x = y1;
+    y = x1 - (a / b) * y1;
+    return gcd;
+}
+
+// returns the remainder of a divided by b that is not negative.
+static int64_t floor_mod(int64_t a, int64_t b)
+{
+    return ((a % b) + b) % b;
+}
+
+Dated_meeting::Dated_meeting(ifstream& is, const People_t& people, int room_number_) :
+    room_number(room_number_)
+{
+    string first_text, last_text, time_text;
+    int num_participants, num_cancelled;
+    is >> first_text >> last_text >> period >> time_text >> topic >> num_participants >> num_cancelled;
+    file_invalid_data_check(is);
+    if (!parse_date(first_text, first_date) || !parse_date(last_text, last_date) || period < 1 ||
+            last_date < first_date || (last_date - first_date) % period ||
+            !parse_time_span(time_text, start, duration) || num_participants < 0 || num_cancelled < 0)
+    {
+        throw Error(invalid_file_data_message_c);
+    }
+
+    while (num_participants--)
+    {
+        string lastname;
+        is >> lastname;
+        file_invalid_data_check(is);
+        Person* person = people.find(lastname);
+        if (!person || !participants.insert(person))
+        {
+            throw Error(invalid_file_data_message_c);
+        }
+    }
+    while (num_cancelled--)
+    {
+        string date_text;
+        int date;
+        is >> date_text;
+        file_invalid_data_check(is);
+        if (!parse_date(date_text, date) || !occurs_on(date))
+        {
+            throw Error(invalid_file_data_message_c);
+        }
+        cancel(date);
+    }
+}
+
+bool Dated_meeting::occurs_on(int date) const
+{
+    return date >= first_date && date <= last_date && (date - first_date) % period == 0 &&
+        !cancelled_dates.count(date);
+}
+
+int Dated_meeting::next_occurrence(int date) const
+{
+    // the first date the meeting repeats on, then the ones after it that are cancelled.
+    int next = (date <= first_date) ? first_date : first_date + (date - first_date + period - 1) / period * period;
+    while (next <= last_date && cancelled_dates.count(next))
+    {
+        next += period;
+    }
+    return next;
+}
+
+bool Dated_meeting::occurs_with(const Dated_meeting& other) const
+{
+    int64_t from = max(first_date, other.first_date);
+    int64_t to = min(last_date, other.last_date);
+    if (from > to)
+    {
+        return false;
+    }
+    // the common dates are first_date + period * k for the k with
+    // period * k = other.first_date - first_date (mod other.period).
+    int64_t x, y;
+    int64_t gcd = extended_gcd(period, other.period, x, y);
+    int64_t difference = int64_t(other.first_date) - first_date;
+    if (difference % gcd)
+    {
+        return false;
+    }
+    int64_t other_step = other.period / gcd;
+    int64_t k = floor_mod(floor_mod(difference / gcd, other_step) * floor_mod(x, other_step), other_step);
+    int64_t common_period = period * other_step;
+    int64_t date = from + floor_mod(first_date + period * k - from, common_period);
+    // each common date passed over is cancelled in one of the meetings.
+    for (; date <= to; date += common_period)
+    {
+        if (!cancelled_dates.count(date) && !other.cancelled_dates.count(date))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Dated_meeting::add_participant(Person* p)
+{
+    if (!participants.insert(p))
+    {
+        throw Error(participant_exists_message_c);
+    }
+}
+
+void Dated_meeting::remove_participant(const Person* p)
+{
+    if (!participants.erase(p))
+    {
+        throw Error("This person is not a participant in the meeting!");
+    }
+}
+
+void Dated_meeting::for_each_participant(function<void(Person*)> func) const
+{
+    for_each(participants.begin(), participants.end(), func);
+}
+
+void Dated_meeting::add_participant_commitments()
+{
+    for_each(participants.begin(), participants.end(),
+            [this](Person* person){ person->add_dated_commitment(this); });
+}
+
+void Dated_meeting::remove_participant_commitments() const
+{
+    for_each(participants.begin(), participants.end(),
+            [this](Person* person){ person->remove_dated_commitment(this); });
+}
+
+bool Dated_meeting::has_participant_commitment_conflict(const Dated_meeting* except) const
+{
+    return any_of(participants.begin(), participants.end(),
+            [this, except](const Person* person){ return person->has_dated_commitment_conflict(*this, except); });
+}
+
+void Dated_meeting::save(ostream& os) const
+{
+    print_date(os, first_date);
+    os << " ";
+    print_date(os, last_date);
+    os << " " << period << " ";
+    print_time_span(os, start, duration);
+    os << " " << topic << " " << participants.size() << " " << cancelled_dates.size() << endl;
+    for_each(participants.begin(), participants.end(),
+            [&os](const Person* person){ os << person->get_lastname() << endl; });
+    for_each(cancelled_dates.begin(), cancelled_dates.end(),
+            [&os](int date){ print_date(os, date); os << endl; });
+}
+
+void print_occurrence(ostream& os, int date, const Dated_meeting* meeting)
+{
+    print_date(os, date);
+    os << " Room:" << meeting->get_room_number() << " Time: ";
+    print_time_span(os, meeting->get_start(), meeting->get_duration());
+    os << " Topic: " << meeting->get_topic() << endl;
+}
@@ -0,0 +1,127 @@
+#ifndef DATED_MEETING_H
+#define DATED_MEETING_H
+
+#include "Utility.h"
+#include "Participant_set.h"
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <set>
+#include <string>
+
+class Person;
+
+/* A Dated_meeting is a meeting in a room on a date, or one that repeats every period
+days from its first date up to its last date, such as a weekly standup for a year.
+A repeating meeting is stored once, with one topic and one list of participants,
+however many dates it occurs on: the dates are worked out from the first date and
+the period when they are needed. An occurrence on one date can be cancelled, which
+records the date as an exception without touching the rest of the meeting.
+
+Whether two meetings ever occur on the same date is worked out the same way. The
+dates they share are the solutions of two congruences, which repeat every least
+common multiple of the periods, so only the first shared date, and the ones after
+it while those are cancelled, are looked at; never every date between the first and
+the last.
+
+Participants are kept as in a Meeting, and are committed to the meeting as a whole:
+a person's commitments are checked against it on every date it occurs on.
+*/
+
+class Dated_meeting {
+public:
+    // Construct a meeting in the room on first_date, repeating every period days up
+    // to last_date, that starts at the minute of the day start (see Meeting::get_start)
+    // and lasts duration minutes.
+    Dated_meeting(int room_number_, int first_date_, int last_date_, int period_,
+            int start_, int duration_, const std::string& topic_) :
+        room_number(room_number_),
+        first_date(first_date_),
+        last_date(last_date_),
+        period(period_),
+        start(start_),
+        duration(duration_),
+        topic(topic_) {}
+
+    // Construct a Dated_meeting from an input file stream in save format, adding
+    // its participants, who are found in the people list, but not their commitments.
+    // Throw Error exception if invalid data discovered in file.
+    Dated_meeting(std::ifstream& is, const People_t& people, int room_number_);
+
+    // accessors
+    int get_room_number() const
+        { return room_number; }
+    int get_first_date() const
+        { return first_date; }
+    int get_last_date() const
+        { return last_date; }
+    int get_period() const
+        { return period; }
+    // the minutes of the day the meeting starts and ends at, and its duration.
+    int get_start() const
+        { return start; }
+    int get_end() const
+        { return start + duration; }
+    int get_duration() const
+        { return duration; }
+    const std::string& get_topic() const
+        { return topic; }
+    bool is_repeating() const
+        { return first_date != last_date; }
+
+    // Return true if the meeting occurs on the date.
+    bool occurs_on(int date) const;
+    // Returns the first date on or after the date that the meeting occurs on,
+    // or a date after its last date if there is none.
+    int next_occurrence(int date) const;
+    // Returns the number of dates from the first to the last date that the meeting
+    // repeats on, cancelled ones included.
+    int get_number_dates() const
+        { return (last_date - first_date) / period + 1; }
+    // Return true if this meeting and the other occur on a common date.
+    bool occurs_with(const Dated_meeting& other) const;
+    // Cancel the occurrence on the date, which must be one the meeting occurs on,
+    // or restore a cancelled one.
+    void cancel(int date)
+        { cancelled_dates.insert(date); }
+    void restore(int date)
+        { cancelled_dates.erase(date); }
+
+    // Add to the list, throw exception if participant was already there.
+    void add_participant(Person* p);
+    // Return true if the person is a participant, false if not.
+    bool is_participant_present(const Person* p) const
+        { return participants.contains(p); }
+    // Remove from the list, throw exception if participant was not found.
+    void remove_participant(const Person* p);
+    // Call the function with each participant, in last name order.
+    void for_each_participant(std::function<void(Person*)> func) const;
+
+    // Add or remove the commitment of each participant to this meeting.
+    void add_participant_commitments();
+    void remove_participant_commitments() const;
+    // Return true if a participant is committed to a dated meeting other than the
+    // except one at some of the same minutes on a date this meeting occurs on.
+    bool has_participant_commitment_conflict(const Dated_meeting* except) const;
+
+    // Write the meeting's data to a stream in save format with final endl.
+    void save(std::ostream& os) const;
+
+private:
+    int room_number;
+    int first_date;
+    int last_date;
+    int period;
+    int start;
+    int duration;
+    std::string topic;
+    // the dates whose occurrence has been cancelled
+    std::set<int> cancelled_dates;
+    Participant_set participants;
+};
+
+// Print the occurrence of the meeting on the date as the date followed by the
+// room, meeting time and topic in the format of a person's commitments, with an endl.
+void print_occurrence(std::ostream& os, int date, const Dated_meeting* meeting);
+
+#endif
@@ -0,0 +1,60 @@
+#include "Epoch.h"
+#include <algorithm>
+
+using namespace std;
+
+Epoch_domain::Epoch_domain(int num_readers) :
+    global_epoch(1),
+    slots(max(num_readers, 1))
+{}
+
+void Epoch_domain::enter(int reader_index)
+{
+    // a plain store; the sequentially consistent ordering makes it visible to
+    // a writer's scan before this reader loads any published pointer.
+    slots[reader_index].epoch.store(global_epoch.load());
+}
+
+void Epoch_domain::leave(int reader_index)
+{
+    slots[reader_index].epoch.store(0, memory_order_release);
+}
+
+uint64_t Epoch_domain::advance()
+{
+    return global_epoch.fetch_add(1);
+}
+
+uint64_t Epoch_domain::oldest_active() const
+{
+    uint64_t oldest = global_epoch.load();
+    for (const Slot& slot : slots)
+    {
+        uint64_t epoch = slot.epoch.load();
+        if (epoch != 0 && epoch < oldest)
+        {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+void Retire_list::reclaim()
+{
+    if (retired.empty())
+    {
+        return;
+    }
+    // an object tagged with epoch e may be held by a reader that entered in e or before.
+    uint64_t oldest = domain.oldest_active();
+    auto still_visible = partition(retired.begin(), retired.end(),
+            [oldest](const Retired& r){ return r.epoch >= oldest; });
+    for_each(still_visible, retired.end(), [](const Retired& r){ r.deleter(r.object); });
+    retired.erase(still_visible, retired.end());
+}
+
+void Retire_list::clear()
+{
+    for_each(retired.begin(), retired.end(), [](const Retired& r){ r.deleter(r.object); });
+    retired.clear();
+}
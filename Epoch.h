@@ -0,0 +1,109 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/* Epoch-based reclamation of objects shared with lock-free readers.
+
+An Epoch_domain has a global epoch counter and a fixed number of reader slots, one
+per reader thread. A reader announces the epoch it is reading in by storing it into
+its own slot (an Epoch_guard does this for a scope), and clears the slot when it is
+done. Readers never lock and never perform an atomic read-modify-write.
+
+A writer that unpublishes an object hands it to a Retire_list, which tags it with
+the current epoch and advances the epoch. The object is deleted by reclaim() once
+no reader is still inside an epoch at or before the tag, since only those readers
+could have seen the object before it was unpublished.
+*/
+
+class Epoch_domain {
+public:
+    // Create a domain for the specified number of reader threads.
+    explicit Epoch_domain(int num_readers);
+
+    Epoch_domain(const Epoch_domain&) = delete;
+    Epoch_domain& operator= (const Epoch_domain&) = delete;
+
+    // Enter and leave a read-side critical section on behalf of the reader.
+    void enter(int reader_index);
+    void leave(int reader_index);
+
+    // Returns the current epoch and advances it. Used to tag retired objects.
+    std::uint64_t advance();
+
+    // Returns the oldest epoch some reader is currently in,
+    // or the current epoch if no reader is active.
+    std::uint64_t oldest_active() const;
+
+private:
+    // each slot gets its own cache line so that readers do not contend.
+    struct Slot {
+        Slot() : epoch(0) {}
+        std::atomic<std::uint64_t> epoch;   // 0 means not reading
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+    std::atomic<std::uint64_t> global_epoch;
+    std::vector<Slot> slots;
+};
+
+// Keeps a reader inside an epoch for the lifetime of the guard.
+class Epoch_guard {
+public:
+    Epoch_guard(Epoch_domain& domain_, int reader_index_) :
+        domain(domain_), reader_index(reader_index_)
+        { domain.enter(reader_index); }
+    ~Epoch_guard()
+        { domain.leave(reader_index); }
+
+    Epoch_guard(const Epoch_guard&) = delete;
+    Epoch_guard& operator= (const Epoch_guard&) = delete;
+
+private:
+    Epoch_domain& domain;
+    int reader_index;
+};
+
+/* A list of unpublished objects waiting to be deleted. A Retire_list belongs to
+a single writer thread and is not itself thread-safe. */
+class Retire_list {
+public:
+    explicit Retire_list(Epoch_domain& domain_) : domain(domain_) {}
+    // Deletes everything still on the list; no reader may be active.
+    ~Retire_list()
+        { clear(); }
+
+    Retire_list(const Retire_list&) = delete;
+    Retire_list& operator= (const Retire_list&) = delete;
+
+    // Hand over an unpublished object, to be deleted once no reader can see it.
+    template<typename T>
+    void retire(const T* object)
+        { if (object) retired.push_back(Retired{domain.advance(), object, &delete_object<T>}); }
+
+    // Delete the objects that no reader can see any more.
+    void reclaim();
+
+    // Delete all objects on the list; no reader may be active.
+    void clear();
+
+    // Returns the number of objects waiting to be deleted.
+    int size() const
+        { return retired.size(); }
+
+private:
+    template<typename T>
+    static void delete_object(const void* object)
+        { delete static_cast<const T*>(object); }
+
+    struct Retired {
+        std::uint64_t epoch;
+        const void* object;
+        void (*deleter)(const void*);
+    };
+    Epoch_domain& domain;
+    std::vector<Retired> retired;
+};
+
+#endif
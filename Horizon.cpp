@@ -0,0 +1,209 @@
+#include "Horizon.h"
+#include "Dated_meeting.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+// the minute, counted across dates, at which the minute of the day falls on the date.
+static int date_minute(int date, int minute)
+{
+    return date * minutes_per_day_c + minute;
+}
+
+// the date a minute counted across dates falls on.
+static int minute_date(int minute)
+{
+    return (minute >= 0) ? minute / minutes_per_day_c : -((minutes_per_day_c - 1 - minute) / minutes_per_day_c);
+}
+
+// Return true if the meetings take some of the same minutes of the day or, if
+// same_hour is true, start in the same hour.
+static bool times_conflict(const Dated_meeting& meeting1, const Dated_meeting& meeting2, bool same_hour)
+{
+    return (meeting1.get_start() < meeting2.get_end() && meeting2.get_start() < meeting1.get_end()) ||
+        (same_hour && meeting1.get_start() / minutes_per_slot_c == meeting2.get_start() / minutes_per_slot_c);
+}
+
+bool Horizon::has_conflict(const Dated_meeting& meeting, bool same_hour, const Dated_meeting* except) const
+{
+    for (const Dated_meeting* repeating : repeating_meetings)
+    {
+        if (repeating != except && times_conflict(meeting, *repeating, same_hour) && meeting.occurs_with(*repeating))
+        {
+            return true;
+        }
+    }
+    if (single_meetings.empty())
+    {
+        return false;
+    }
+    // look up each date of the meeting, or look at each single meeting within its
+    // dates, whichever is fewer.
+    if (static_cast<size_t>(meeting.get_number_dates()) <= single_meetings.size())
+    {
+        for (int date = meeting.next_occurrence(meeting.get_first_date()); date <= meeting.get_last_date();
+                date = meeting.next_occurrence(date + 1))
+        {
+            if (has_single_conflict(date, meeting.get_start(), meeting.get_end(), same_hour, except))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    int end = date_minute(meeting.get_last_date() + 1, 0);
+    bool conflict = false;
+    single_meetings.for_each_from(date_minute(meeting.get_first_date(), 0),
+            [&meeting, same_hour, except, end, &conflict](const Single_meetings_t::Interval& interval)
+            {
+                if (interval.begin >= end)
+                {
+                    return false;
+                }
+                conflict = interval.value != except && meeting.occurs_on(minute_date(interval.begin)) &&
+                    times_conflict(meeting, *interval.value, same_hour);
+                return !conflict;
+            });
+    return conflict;
+}
+
+bool Horizon::has_single_conflict(int date, int start, int end, bool same_hour, const Dated_meeting* except) const
+{
+    auto other = [except](const Single_meetings_t::Interval& interval){ return interval.value == except; };
+    if (!single_meetings.for_each_overlapping(date_minute(date, start), date_minute(date, end), other))
+    {
+        return true;
+    }
+    if (!same_hour)
+    {
+        return false;
+    }
+    int hour_start = start / minutes_per_slot_c * minutes_per_slot_c;
+    int hour_end = date_minute(date, hour_start + minutes_per_slot_c);
+    bool conflict = false;
+    single_meetings.for_each_from(date_minute(date, hour_start),
+            [except, hour_end, &conflict](const Single_meetings_t::Interval& interval)
+            {
+                conflict = interval.begin < hour_end && interval.value != except;
+                return interval.begin < hour_end && !conflict;
+            });
+    return conflict;
+}
+
+Dated_meeting* Horizon::find(int date, int time) const
+{
+    int hour_start = date_minute(date, time_minute(time));
+    Dated_meeting* found = nullptr;
+    single_meetings.for_each_from(hour_start, [hour_start, &found](const Single_meetings_t::Interval& interval)
+            {
+                if (interval.begin < hour_start + minutes_per_slot_c)
+                {
+                    found = interval.value;
+                }
+                return false;
+            });
+    for (auto meeting_it = repeating_meetings.begin(); !found && meeting_it != repeating_meetings.end(); ++meeting_it)
+    {
+        if ((*meeting_it)->get_start() / minutes_per_slot_c == time_slot(time) && (*meeting_it)->occurs_on(date))
+        {
+            found = *meeting_it;
+        }
+    }
+    return found;
+}
+
+void Horizon::insert(Dated_meeting* meeting)
+{
+    if (meeting->is_repeating())
+    {
+        repeating_meetings.push_back(meeting);
+    }
+    else
+    {
+        int begin = date_minute(meeting->get_first_date(), meeting->get_start());
+        single_meetings.insert(begin, begin + meeting->get_duration(), meeting);
+    }
+}
+
+void Horizon::erase(const Dated_meeting* meeting)
+{
+    if (meeting->is_repeating())
+    {
+        auto meeting_it = find_if(repeating_meetings.begin(), repeating_meetings.end(),
+                [meeting](const Dated_meeting* repeating){ return repeating == meeting; });
+        if (meeting_it != repeating_meetings.end())
+        {
+            repeating_meetings.erase(meeting_it);
+        }
+    }
+    else
+    {
+        single_meetings.erase(date_minute(meeting->get_first_date(), meeting->get_start()));
+    }
+}
+
+void Horizon::clear()
+{
+    single_meetings.clear();
+    repeating_meetings.clear();
+}
+
+void Horizon::for_each_occurrence(int first_date, int last_date,
+        function<void(int, const Dated_meeting*)> func) const
+{
+    // the next occurrence of each repeating meeting in the range, earliest on top.
+    using Occurrence = pair<int, const Dated_meeting*>;
+    auto later = [](const Occurrence& occurrence1, const Occurrence& occurrence2)
+        {
+            return occurrence1.first != occurrence2.first ? occurrence1.first > occurrence2.first :
+                occurrence1.second->get_start() > occurrence2.second->get_start();
+        };
+    priority_queue<Occurrence, vector<Occurrence>, decltype(later)> next_occurrences(later);
+    for (const Dated_meeting* meeting : repeating_meetings)
+    {
+        int date = meeting->next_occurrence(first_date);
+        if (date <= min(last_date, meeting->get_last_date()))
+        {
+            next_occurrences.push(Occurrence(date, meeting));
+        }
+    }
+    // write the repeating occurrences before the minute, replacing each with the next.
+    auto write_before = [&next_occurrences, &func, last_date](int minute)
+        {
+            while (!next_occurrences.empty() &&
+                    date_minute(next_occurrences.top().first, next_occurrences.top().second->get_start()) < minute)
+            {
+                Occurrence occurrence = next_occurrences.top();
+                next_occurrences.pop();
+                func(occurrence.first, occurrence.second);
+                int date = occurrence.second->next_occurrence(occurrence.first + 1);
+                if (date <= min(last_date, occurrence.second->get_last_date()))
+                {
+                    next_occurrences.push(Occurrence(date, occurrence.second));
+                }
+            }
+        };
+    int end = date_minute(last_date + 1, 0);
+    single_meetings.for_each_from(date_minute(first_date, 0),
+            [&write_before, &func, end](const Single_meetings_t::Interval& interval)
+            {
+                if (interval.begin >= end)
+                {
+                    return false;
+                }
+                write_before(interval.begin);
+                func(interval.value->get_first_date(), interval.value);
+                return true;
+            });
+    write_before(end);
+}
+
+void Horizon::for_each_meeting(function<void(Dated_meeting*)> func) const
+{
+    single_meetings.for_each_from(numeric_limits<int>::min(),
+            [&func](const Single_meetings_t::Interval& interval){ func(interval.value); return true; });
+    for_each(repeating_meetings.begin(), repeating_meetings.end(), func);
+}
@@ -0,0 +1,71 @@
+#ifndef HORIZON_H
+#define HORIZON_H
+
+#include "Interval_map.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class Dated_meeting;
+
+/* A Horizon holds the dated meetings of a room, or those a person is committed to,
+over all dates.
+
+Meetings on a single date are kept in an Interval_map of the minutes they take
+counted across dates (see parse_date), so an overlap with one of them is found by
+one search of the tree. Repeating meetings are kept once each in a vector, and are
+checked against a meeting with Dated_meeting::occurs_with, which does not step
+through their dates. A repeating meeting is checked against the single ones on the
+dates it occurs on, or the single ones within its dates are checked against it,
+whichever there are fewer of.
+
+The occurrences in a range of dates are produced in date and time order as they are
+needed: the single meetings are read from the tree, and each repeating meeting's
+next date is worked out from the last one and merged in through a heap, so a range
+costs the occurrences in it, not the whole horizon, and nothing is stored for them.
+
+A Horizon does not own its meetings.
+*/
+
+class Horizon {
+public:
+    bool empty() const
+        { return single_meetings.empty() && repeating_meetings.empty(); }
+    std::size_t size() const
+        { return single_meetings.size() + repeating_meetings.size(); }
+
+    // Return true if a meeting other than the except one occurs on a date that the
+    // meeting does, and takes some of the same minutes or, if same_hour is true,
+    // starts in the same hour.
+    bool has_conflict(const Dated_meeting& meeting, bool same_hour, const Dated_meeting* except = nullptr) const;
+
+    // Returns the meeting that occurs on the date and starts in the hour from the
+    // time, or nullptr if there is none.
+    Dated_meeting* find(int date, int time) const;
+
+    // Add the meeting, or remove it if it is there.
+    void insert(Dated_meeting* meeting);
+    void erase(const Dated_meeting* meeting);
+    void clear();
+
+    // Call the function with the date and meeting of each occurrence from
+    // first_date to last_date, in date and time order.
+    void for_each_occurrence(int first_date, int last_date,
+            std::function<void(int date, const Dated_meeting* meeting)> func) const;
+
+    // Call the function with each meeting: the single ones in date and time
+    // order, then the repeating ones in the order they were added.
+    void for_each_meeting(std::function<void(Dated_meeting* meeting)> func) const;
+
+private:
+    using Single_meetings_t = Interval_map<Dated_meeting*>;
+
+    // Return true if a single meeting other than the except one takes some of the
+    // minutes from start to end of the date or, if same_hour, starts in the hour of start.
+    bool has_single_conflict(int date, int start, int end, bool same_hour, const Dated_meeting* except) const;
+
+    Single_meetings_t single_meetings;
+    std::vector<Dated_meeting*> repeating_meetings;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef INTERVAL_MAP_H
+#define INTERVAL_MAP_H
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+
+/* An Interval_map holds half-open intervals [begin, end) of minutes that do not
+overlap each other, each with a value, such as the meetings of a room or the
+commitments of a person.
+
+The intervals are kept in a balanced tree ordered by where they begin, so adding
+or removing one takes O(log n) time. Because they do not overlap, ordering them by
+beginning also orders them by end, so the intervals that overlap a given one are
+consecutive: they start with the first interval ending after it begins, which is
+the one before the first interval beginning after it begins, or that interval
+itself. Finding whether anything overlaps an interval is therefore one search of
+the tree, however many intervals there are.
+*/
+
+template<typename T>
+class Interval_map {
+public:
+    struct Interval {
+        int begin;
+        int end;
+        T value;
+    };
+
+    bool empty() const
+        { return intervals.empty(); }
+    std::size_t size() const
+        { return intervals.size(); }
+
+    // Add the interval, which must not overlap any of the others.
+    void insert(int begin, int end, const T& value)
+        { intervals.emplace_hint(intervals.lower_bound(begin), begin, Interval{begin, end, value}); }
+
+    // Remove the interval beginning at begin, if there is one.
+    void erase(int begin)
+        { intervals.erase(begin); }
+
+    void clear()
+        { intervals.clear(); }
+
+    // Returns true if an interval overlaps [begin, end).
+    bool overlaps(int begin, int end) const
+        { return !for_each_overlapping(begin, end, [](const Interval&){ return false; }); }
+
+    // Call the function with each interval that overlaps [begin, end), in order,
+    // until it returns false. Returns false if the function did.
+    template<typename F>
+    bool for_each_overlapping(int begin, int end, F func) const
+    {
+        auto interval_it = intervals.upper_bound(begin);
+        if (interval_it != intervals.begin() && std::prev(interval_it)->second.end > begin)
+        {
+            --interval_it;
+        }
+        for (; interval_it != intervals.end() && interval_it->first < end; ++interval_it)
+        {
+            if (!func(interval_it->second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Call the function with each interval that begins at or after begin, in
+    // order, until it returns false.
+    template<typename F>
+    void for_each_from(int begin, F func) const
+    {
+        for (auto interval_it = intervals.lower_bound(begin);
+                interval_it != intervals.end() && func(interval_it->second); ++interval_it);
+    }
+
+private:
+    std::map<int, Interval> intervals;
+};
+
+#endif
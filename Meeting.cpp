@@ -1,4 +1,5 @@
 #include "Meeting.h"
+#include "People_directory.h"
 #include "Person.h"
 #include <algorithm>
 #include <iterator>
@@ -6,11 +7,17 @@
 
 using namespace std;
 
-Meeting::Meeting(ifstream& is, const People_t& people, int room_number)
+Meeting::Meeting(ifstream& is, const People_t& people, int room_number) :
+    version(0)
 {
     int num_participants;
-    is >> time >> topic >> num_participants;
+    string time_text;
+    is >> time_text >> topic >> num_participants;
     file_invalid_data_check(is);
+    if (!parse_time_span(time_text, start, duration))
+    {
+        throw Error(invalid_file_data_message_c);
+    }
     
     while(num_participants--)
     {
@@ -18,90 +25,92 @@ Meeting::Meeting(ifstream& is, const People_t& people, int room_number)
         is >> lastname;
         file_invalid_data_check(is);
         // Insert person in people's list into participants list if person exists.
-        Person probe(lastname);
-        auto people_it = people.find(&probe);
-        if (people_it == people.end())
+        Person* person = people.find(lastname);
+        if (!person)
         {
             throw Error(invalid_file_data_message_c);
         }
-        add_participant(*people_it);
-        // add the commitment for the participant in this room.
-        (*people_it)->add_commitment(room_number, this);
+        // add the commitment for the participant in this room first, so that
+        // the participant is not added if it conflicts.
+        person->add_commitment(room_number, this);
+        add_participant(person);
     }
 }
 
-void Meeting::add_participant(const Person* p)
+void Meeting::add_participant(Person* p)
 {
-    // searches and gets and iterator to  the first occurence of a 
-    // person in the list whose lastname is larger than p 
-    auto insert_it = find_if(participants.begin(), participants.end(), 
-            bind(Less_than_ptr<const Person*>(), p, placeholders::_1)); 
-    participants.insert(insert_it, p);
+    participants.insert(p);
+    ++version;
 }
 
 bool Meeting::is_participant_present(const Person* p) const
 {
-    // if find returns end, participant is not present. 
-    return find(participants.begin(), participants.end(), p) != participants.end();
+    return participants.contains(p);
 }
 
 void Meeting::remove_participant(const Person* p)
 {
-    // linear search for list
-    if(find(participants.begin(), participants.end(), p) == participants.end())
+    if(!participants.erase(p))
     {
         throw Error("This person is not a participant in the meeting!");
     }
-    participants.remove(p);
+    ++version;
+}
+
+void Meeting::for_each_participant(function<void(const Person*)> func) const
+{
+    for_each(participants.begin(), participants.end(), func);
 }
         
 void Meeting::save(ostream& os) const
 {
-    os << time << " " << topic << " " << participants.size() << endl;
+    print_time_span(os, start, duration);
+    os << " " << topic << " " << participants.size() << endl;
     for_each(participants.begin(), participants.end(), 
             [&os](const Person* person){os << person->get_lastname() << endl;});
 }
 
-bool Meeting::has_participant_commitment_conflict(int old_meeting_time, int new_meeting_time) const
+void Meeting::add_participant_commitments(int room_number) const
 {
-    // Changing the room but not the time should not cause
-    // a commitment conflict.
-    if (old_meeting_time == new_meeting_time)
-    {
-        return false;
-    }
+    for_each(participants.begin(), participants.end(),
+            bind(&Person::add_commitment, placeholders::_1, room_number, this));
+}
 
-    // returns true if any of the participants has a commitment conflict.
-    return any_of(participants.begin(), participants.end(), 
-            bind(&Person::has_commitment_conflict, placeholders::_1, new_meeting_time));
+void Meeting::remove_participant_commitments(int room_number) const
+{
+    for_each(participants.begin(), participants.end(),
+            bind(&Person::remove_commitment, placeholders::_1, room_number, get_time()));
 }
 
-int Meeting::format_time(const int time) const
+bool Meeting::has_participant_commitment_conflict(int new_meeting_time) const
 {
-    /* Time should be from 9am to 5pm. */
-    return (time<=5) ? time+12 : time;
+    // the participants' commitments to this meeting do not conflict with it, so
+    // changing the room but not the time never causes a conflict.
+    int new_start = time_minute(new_meeting_time) + start % minutes_per_slot_c;
+
+    // returns true if any of the participants has a commitment conflict.
+    return any_of(participants.begin(), participants.end(), 
+            bind(&Person::has_commitment_conflict, placeholders::_1, new_start, new_start + duration, this));
 }
-// This operator defines the order relation between meetings, based just on the time
+
+// This operator defines the order relation between meetings, based just on the start
 bool Meeting::operator< (const Meeting& other) const
 {
-    return (format_time(time) < format_time(other.time));
+    return start < other.start;
 }
 
 ostream& operator<< (ostream& os, const Meeting& meeting)
 {
-    os << "Meeting time: " << meeting.time << ", Topic: " << meeting.topic << "\nParticipants:";
-    if (meeting.participants.empty())
-    {
-        os << " None" << endl;
-    }
-    else
-    {
-        os << endl;
-        // initialize ostream iterator with newline
-        ostream_iterator<const Person*> os_it(os, "\n");
-        // copy each participant into the ostream iterator.
-        copy(meeting.participants.begin(),
-                meeting.participants.end(), os_it);
-    }
+    // an unchanged meeting is printed from its cached text.
+    meeting.render_cache.print(os, meeting.version, [&meeting](ostream& text)
+            {
+                print_meeting_heading(text, meeting.start, meeting.duration, meeting.topic,
+                        !meeting.participants.empty());
+                // initialize ostream iterator with newline
+                ostream_iterator<const Person*> os_it(text, "\n");
+                // copy each participant into the ostream iterator.
+                copy(meeting.participants.begin(),
+                        meeting.participants.end(), os_it);
+            });
     return os;
 }
@@ -2,23 +2,34 @@
 #define MEETING_H
 
 #include "Utility.h"
+#include "Participant_set.h"
+#include "Render_cache.h"
 #include <fstream>
+#include <functional>
 #include <string>
-#include <list>
 
 class Person;
 
 class Meeting {
 public:
     Meeting(int time_, const std::string& topic_) :
-        participants(Participants_t()),
-        time(time_),
-        topic(topic_) {}
+        start(time_minute(time_)),
+        duration(minutes_per_slot_c),
+        topic(topic_),
+        version(0) {}
 	// construct a Meeting with only a time
 	Meeting(int time_) :
-        participants(Participants_t()),
-        time(time_),
-        topic(std::string()) {}
+        start(time_minute(time_)),
+        duration(minutes_per_slot_c),
+        topic(std::string()),
+        version(0) {}
+    // construct a Meeting from its start, a minute of the day, and its duration in
+    // minutes (see parse_time_span).
+    Meeting(int start_, int duration_, const std::string& topic_) :
+        start(start_),
+        duration(duration_),
+        topic(topic_),
+        version(0) {}
 
     // Construct a Meeting from an input file stream in save format
     // Throw Error exception if invalid data discovered in file.
@@ -30,46 +41,67 @@ public:
     Meeting(std::ifstream& is, const People_t& people, int room_number);
 
     // accessors
+    // the meeting time the meeting starts in, which is how commands name it.
     int get_time() const
-        { return time; }
+        { return slot_time(start / minutes_per_slot_c); }
+    // the minutes of the day the meeting starts and ends at, and its duration.
+    int get_start() const
+        { return start; }
+    int get_end() const
+        { return start + duration; }
+    int get_duration() const
+        { return duration; }
     std::string get_topic() const
         { return topic; }
+    // Move the meeting to the meeting time, keeping its minutes past the hour and its duration.
 	void set_time(int time_)
-		{ time = time_; }
+		{ start = time_minute(time_) + start % minutes_per_slot_c; ++version; }
 
     // Meeting objects manage their own participant list. Participants
     // are identified by a pointer to that individual's Person object.
 
     // Add to the list, throw exception if participant was already there.
-    void add_participant(const Person* p);
+    void add_participant(Person* p);
     // Return true if the person is a participant, false if not.
     bool is_participant_present(const Person* p) const;
     // Remove from the list, throw exception if participant was not found.
     void remove_participant(const Person* p);
+    // Call the function with each participant, in last name order.
+    void for_each_participant(std::function<void(const Person*)> func) const;
 			
     // Write a Meeting's data to a stream in save format with final endl.
     void save(std::ostream& os) const;
 
-    // Checks all the participants in the meeting for a commitment conflict
-    // given the old and new meeting times. This is used when meetings are being
-    // rescheduled.
-    bool has_participant_commitment_conflict(int old_meeting_time, int new_meeting_time) const;
+    // Add or remove the commitment of each participant to this meeting in the room.
+    // These change only the meeting's own participants, however many people there are.
+    void add_participant_commitments(int room_number) const;
+    void remove_participant_commitments(int room_number) const;
 
+    // Checks all the participants in the meeting for a commitment, other than to
+    // this meeting, that overlaps the meeting if it were moved to the new meeting
+    // time. This is used when meetings are being rescheduled.
+    bool has_participant_commitment_conflict(int new_meeting_time) const;
 
-    // This operator defines the order relation between meetings, based just on the time
+
+    // This operator defines the order relation between meetings, based just on the start
     bool operator< (const Meeting& other) const;
 	
     friend std::ostream& operator<< (std::ostream& os, const Meeting& meeting);
 		
 private:
-    // converts time to 24hr format for comparison.
-    int format_time(const int time) const;
-    // a list of const person pointers to store participants for this meeting.
-    using Participants_t = std::list<const Person*>;
-    Participants_t participants;
+    // the participants of this meeting; they are not const because the
+    // meeting updates its participants' commitments.
+    Participant_set participants;
 
-    int time;
+    // the minute of the day the meeting starts at, and its length in minutes
+    int start;
+    int duration;
     std::string topic;
+
+    // bumped by every change that shows in the output operator's text,
+    // and that text for the version it was last printed at.
+    unsigned long version;
+    Render_cache render_cache;
 };
 
 // Print the Meeting data as follows:
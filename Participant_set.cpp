@@ -0,0 +1,114 @@
+#include "Participant_set.h"
+#include "Person.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// returns the position of the person in the ordered participants, or end if not there.
+static vector<Person*>::const_iterator find_ordered(const vector<Person*>& ordered, const Person* person)
+{
+    auto person_it = lower_bound(ordered.begin(), ordered.end(), person, Less_than_ptr<const Person*>());
+    return (person_it != ordered.end() && *person_it == person) ? person_it : ordered.end();
+}
+
+bool Participant_set::contains(const Person* person) const
+{
+    if (table.empty())
+    {
+        return find_ordered(ordered, person) != ordered.end();
+    }
+    return table[find_slot(person)] == person;
+}
+
+bool Participant_set::insert(Person* person)
+{
+    if (contains(person))
+    {
+        return false;
+    }
+    auto insert_it = upper_bound(ordered.begin(), ordered.end(), person, Less_than_ptr<const Person*>());
+    ordered.insert(insert_it, person);
+
+    // keep the table at most half full.
+    if (ordered.size() > hash_threshold_c && ordered.size() * 2 > table.size())
+    {
+        rebuild_table(max(table.size() * 2, hash_threshold_c * 4));
+    }
+    else if (!table.empty())
+    {
+        table[find_slot(person)] = person;
+    }
+    return true;
+}
+
+bool Participant_set::erase(const Person* person)
+{
+    auto person_it = find_ordered(ordered, person);
+    if (person_it == ordered.end())
+    {
+        return false;
+    }
+    ordered.erase(ordered.begin() + (person_it - ordered.cbegin()));
+
+    if (table.empty())
+    {
+        return true;
+    }
+    if (ordered.size() < hash_threshold_c / 2)
+    {
+        rebuild_table(0);
+        return true;
+    }
+    // remove the person by shifting back the entries after it in its probe
+    // sequence that would no longer be found.
+    size_t mask = table.size() - 1;
+    size_t hole = find_slot(person);
+    table[hole] = nullptr;
+    for (size_t next = (hole + 1) & mask; table[next]; next = (next + 1) & mask)
+    {
+        size_t home = home_slot(table[next]);
+        // the entry can move if its home is not cyclically in (hole, next].
+        bool home_after_hole = (next > hole) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!home_after_hole)
+        {
+            table[hole] = table[next];
+            table[next] = nullptr;
+            hole = next;
+        }
+    }
+    return true;
+}
+
+size_t Participant_set::home_slot(const Person* person) const
+{
+    // mix the address bits, whose low bits are the same for every allocation.
+    uint64_t bits = reinterpret_cast<uintptr_t>(person);
+    bits = (bits ^ (bits >> 29)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(bits >> 32) & (table.size() - 1);
+}
+
+size_t Participant_set::find_slot(const Person* person) const
+{
+    size_t mask = table.size() - 1;
+    size_t slot = home_slot(person);
+    while (table[slot] && table[slot] != person)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void Participant_set::rebuild_table(size_t capacity)
+{
+    table.assign(capacity, nullptr);
+    if (!capacity)
+    {
+        table.shrink_to_fit();
+        return;
+    }
+    for (Person* person : ordered)
+    {
+        table[find_slot(person)] = person;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef PARTICIPANT_SET_H
+#define PARTICIPANT_SET_H
+
+#include <cstddef>
+#include <vector>
+
+class Person;
+
+/* A Participant_set holds the participants of a meeting in last name order.
+
+The participants are kept in a sorted vector, so iterating over them (to print or
+save the meeting) walks contiguous memory, and a participant is found by binary
+search on the last name. A meeting with more than hash_threshold_c participants
+also keeps an open addressing hash table of them, keyed by address, so membership
+is a single probe sequence however large the meeting gets; the table is dropped
+again when the meeting shrinks well below the threshold. Neither structure
+allocates a node per participant.
+*/
+
+class Participant_set {
+public:
+    using const_iterator = std::vector<Person*>::const_iterator;
+
+    // Returns true if the person is in the set.
+    bool contains(const Person* person) const;
+
+    // Add the person, keeping last name order; returns false if they were already there.
+    bool insert(Person* person);
+
+    // Remove the person; returns false if they were not there.
+    bool erase(const Person* person);
+
+    bool empty() const
+        { return ordered.empty(); }
+    std::size_t size() const
+        { return ordered.size(); }
+
+    // The participants in last name order.
+    const_iterator begin() const
+        { return ordered.begin(); }
+    const_iterator end() const
+        { return ordered.end(); }
+
+private:
+    static const std::size_t hash_threshold_c = 64;
+
+    // Returns the table position the person's probe sequence starts at.
+    std::size_t home_slot(const Person* person) const;
+    // Returns the table position holding the person, or the empty one ending its probe sequence.
+    std::size_t find_slot(const Person* person) const;
+    // Rebuild the table with the specified number of positions, a power of two,
+    // or drop it if that is zero.
+    void rebuild_table(std::size_t capacity);
+
+    std::vector<Person*> ordered;
+    // the hash table, with nullptr for empty positions, or empty if the set is small
+    std::vector<Person*> table;
+};
+
+#endif
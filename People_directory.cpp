@@ -0,0 +1,275 @@
+#include "People_directory.h"
+#include "Person.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+using namespace std;
+
+// the number of table positions when the first person is added
+const size_t initial_capacity_c = 16;
+
+Person* People_directory::find(const string& lastname) const
+{
+    if (table.empty())
+    {
+        return nullptr;
+    }
+    return table[find_slot(lastname, hash<string>()(lastname))].person;
+}
+
+People_directory::const_iterator People_directory::upper_bound(const string& lastname) const
+{
+    sort_people();
+    uint64_t key = name_key(lastname);
+    return const_iterator(std::upper_bound(people.cbegin(), people.cend(), lastname,
+            [key](const string& name, const Entry& entry)
+                { return compare_name(entry, name, key, string::npos) > 0; }));
+}
+
+pair<People_directory::const_iterator, People_directory::const_iterator>
+    People_directory::prefix_range(const string& prefix) const
+{
+    sort_people();
+    uint64_t key = name_key(prefix);
+    size_t length = prefix.size();
+    // the names starting with the prefix are those whose first prefix.size()
+    // characters are equal to it.
+    auto first = lower_bound(people.cbegin(), people.cend(), prefix,
+            [key, length](const Entry& entry, const string& name)
+                { return compare_name(entry, name, key, length) < 0; });
+    auto last = std::upper_bound(first, people.cend(), prefix,
+            [key, length](const string& name, const Entry& entry)
+                { return compare_name(entry, name, key, length) > 0; });
+    return make_pair(const_iterator(first), const_iterator(last));
+}
+
+vector<Person*> People_directory::find_people_at(int time)
+{
+    renumber_people();
+    vector<size_t> slot_ids = slot_bitsets->find_ids(time_slot(time), true);
+    vector<Person*> busy_people(slot_ids.size());
+    for (size_t i = 0; i < slot_ids.size(); ++i)
+    {
+        busy_people[i] = people_by_id[slot_ids[i]];
+    }
+    return busy_people;
+}
+
+bool People_directory::insert(Person* person)
+{
+    const string& lastname = person->get_lastname();
+    size_t name_hash = hash<string>()(lastname);
+    // keep the table at most half full.
+    if ((people.size() + 1) * 2 > table.size())
+    {
+        rebuild_table(max(table.size() * 2, initial_capacity_c));
+    }
+    size_t slot = find_slot(lastname, name_hash);
+    if (table[slot].person)
+    {
+        return false;
+    }
+    table[slot] = Slot{person, name_hash};
+
+    Entry entry{name_key(lastname), person};
+    if (sorted.load(memory_order_relaxed) && !people.empty() && !entry_less(people.back(), entry))
+    {
+        sorted.store(false, memory_order_relaxed);
+    }
+    people.push_back(entry);
+
+    size_t slot_id = slot_bitsets->add_id();
+    // a new id keeps the ids in last name order while the people are.
+    if (slot_id != people_by_id.size() || !sorted.load(memory_order_relaxed))
+    {
+        ids_in_order.store(false, memory_order_relaxed);
+    }
+    people_by_id.resize(max(people_by_id.size(), slot_id + 1));
+    people_by_id[slot_id] = person;
+    person->attach_slot_bitsets(slot_bitsets.get(), slot_id);
+    return true;
+}
+
+void People_directory::erase(Person* person)
+{
+    if (table.empty())
+    {
+        return;
+    }
+    size_t mask = table.size() - 1;
+    size_t hole = find_slot(person->get_lastname(), hash<string>()(person->get_lastname()));
+    if (table[hole].person != person)
+    {
+        return;
+    }
+    slot_bitsets->remove_id(person->slot_id);
+    person->attach_slot_bitsets(nullptr, 0);
+
+    // remove the person by shifting back the entries after it in its probe
+    // sequence that would no longer be found.
+    table[hole].person = nullptr;
+    for (size_t next = (hole + 1) & mask; table[next].person; next = (next + 1) & mask)
+    {
+        size_t home = table[next].hash & mask;
+        // the entry can move if its home is not cyclically in (hole, next].
+        bool home_after_hole = (next > hole) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!home_after_hole)
+        {
+            table[hole] = table[next];
+            table[next].person = nullptr;
+            hole = next;
+        }
+    }
+
+    if (sorted.load(memory_order_relaxed))
+    {
+        uint64_t key = name_key(person->get_lastname());
+        people.erase(lower_bound(people.begin(), people.end(), person->get_lastname(),
+                [key](const Entry& entry, const string& name)
+                    { return compare_name(entry, name, key, string::npos) < 0; }));
+    }
+    else
+    {
+        // the order does not matter until the people are sorted.
+        *find_if(people.begin(), people.end(), [person](const Entry& entry){ return entry.person == person; }) =
+            people.back();
+        people.pop_back();
+    }
+}
+
+void People_directory::clear()
+{
+    table.clear();
+    table.shrink_to_fit();
+    people.clear();
+    slot_bitsets->clear();
+    people_by_id.clear();
+    ids_in_order.store(true, memory_order_relaxed);
+    sorted.store(true, memory_order_relaxed);
+}
+
+void People_directory::swap(People_directory& other)
+{
+    table.swap(other.table);
+    people.swap(other.people);
+    slot_bitsets.swap(other.slot_bitsets);
+    people_by_id.swap(other.people_by_id);
+    bool other_ids_in_order = other.ids_in_order.load(memory_order_relaxed);
+    other.ids_in_order.store(ids_in_order.load(memory_order_relaxed), memory_order_relaxed);
+    ids_in_order.store(other_ids_in_order, memory_order_relaxed);
+    bool other_sorted = other.sorted.load(memory_order_relaxed);
+    other.sorted.store(sorted.load(memory_order_relaxed), memory_order_relaxed);
+    sorted.store(other_sorted, memory_order_relaxed);
+}
+
+uint64_t People_directory::name_key(const string& lastname)
+{
+    uint64_t key = 0;
+    for (size_t i = 0; i < key_size_c; ++i)
+    {
+        unsigned char byte = (i < lastname.size()) ? lastname[i] : 0;
+        key = (key << 8) | byte;
+    }
+    return key;
+}
+
+int People_directory::compare_name(const Entry& entry, const string& name, uint64_t key, size_t length)
+{
+    if (length == 0)
+    {
+        return 0;
+    }
+    uint64_t entry_key = entry.key;
+    if (length < key_size_c)
+    {
+        // only the first length bytes of the entry's name are compared.
+        entry_key &= ~uint64_t(0) << (8 * (key_size_c - length));
+    }
+    if (entry_key != key)
+    {
+        return (entry_key < key) ? -1 : 1;
+    }
+    // names shorter than a key are equal if their keys are, because no name has a zero byte.
+    if (name.size() < key_size_c)
+    {
+        return 0;
+    }
+    return entry.person->get_lastname().compare(0, length, name);
+}
+
+bool People_directory::entry_less(const Entry& lhs, const Entry& rhs)
+{
+    if (lhs.key != rhs.key)
+    {
+        return lhs.key < rhs.key;
+    }
+    return *lhs.person < *rhs.person;
+}
+
+size_t People_directory::find_slot(const string& lastname, size_t hash) const
+{
+    size_t mask = table.size() - 1;
+    size_t slot = hash & mask;
+    // the names are only compared when the hashes match.
+    while (table[slot].person &&
+            (table[slot].hash != hash || table[slot].person->get_lastname() != lastname))
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void People_directory::rebuild_table(size_t capacity)
+{
+    vector<Slot> old_table(capacity, Slot{nullptr, 0});
+    old_table.swap(table);
+    size_t mask = capacity - 1;
+    for (const Slot& entry : old_table)
+    {
+        if (entry.person)
+        {
+            size_t slot = entry.hash & mask;
+            while (table[slot].person)
+            {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = entry;
+        }
+    }
+}
+
+void People_directory::sort_people() const
+{
+    if (sorted.load(memory_order_acquire))
+    {
+        return;
+    }
+    lock_guard<mutex> lock(sort_mutex);
+    if (!sorted.load(memory_order_relaxed))
+    {
+        sort(people.begin(), people.end(), entry_less);
+        sorted.store(true, memory_order_release);
+    }
+}
+
+void People_directory::renumber_people()
+{
+    if (ids_in_order.load(memory_order_acquire))
+    {
+        return;
+    }
+    sort_people();
+    lock_guard<mutex> lock(sort_mutex);
+    if (!ids_in_order.load(memory_order_relaxed))
+    {
+        slot_bitsets->clear();
+        people_by_id.clear();
+        for (const Entry& entry : people)
+        {
+            people_by_id.push_back(entry.person);
+            entry.person->attach_slot_bitsets(slot_bitsets.get(), slot_bitsets->add_id());
+        }
+        ids_in_order.store(true, memory_order_release);
+    }
+}
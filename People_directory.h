@@ -0,0 +1,163 @@
+#ifndef PEOPLE_DIRECTORY_H
+#define PEOPLE_DIRECTORY_H
+
+#include "Slot_bitsets.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Person;
+
+/* A People_directory holds the people of a schedule, and finds them by last name.
+
+The people are indexed by an open addressing hash table of pointers keyed by last
+name, which also keeps each person's hash, so a person is found by hashing the name
+and comparing it only with the people whose hash matches: no probe Person is built
+and nothing is allocated. The table is kept at most half full.
+
+Iteration is in last name order. The people are also kept in a vector that is sorted
+on demand: adding a person appends them, which leaves the vector sorted if the names
+arrive in order (as they do from a saved file), and the first iteration after an
+out-of-order add sorts it. Next to each person the vector keeps the first key_size_c
+bytes of their last name packed into an integer, whose order is the order of the
+names, so sorting and the binary searches for a cursor or a prefix compare integers
+in contiguous memory, and only look at a Person when two keys are equal. Sorting is
+guarded by a mutex so that several readers may iterate at once; adding and removing
+people need exclusive access, as they do for any container. Adding or removing a
+person invalidates the iterators.
+
+Each person also has an id in the directory's Slot_bitsets, where they mark the time
+slots they are committed in, so the people who are busy at a time are found by
+scanning a bitset. As with the order of the vector, ids are in last name order while
+people are added in that order, and are otherwise renumbered by the first scan after
+the people were added, under the same mutex.
+
+A directory is not copyable; two directories can be swapped in constant time,
+which is how ld keeps the old people to roll back to. The directory does not own
+the people; they are deleted by whoever removes them.
+*/
+
+class People_directory {
+public:
+    // the number of leading bytes of a last name kept in its key
+    static const std::size_t key_size_c = sizeof(std::uint64_t);
+
+private:
+    // a person in the ordered vector, with the key of their last name
+    struct Entry {
+        std::uint64_t key;
+        Person* person;
+    };
+    using Entries_t = std::vector<Entry>;
+
+public:
+    // iterator over the people of a directory, in last name order
+    class const_iterator : public std::iterator<std::bidirectional_iterator_tag, Person*> {
+    public:
+        const_iterator() {}
+        explicit const_iterator(Entries_t::const_iterator it_) : it(it_) {}
+        Person* const& operator* () const
+            { return it->person; }
+        Person* const* operator-> () const
+            { return &it->person; }
+        const_iterator& operator++ ()
+            { ++it; return *this; }
+        const_iterator operator++ (int)
+            { const_iterator old = *this; ++it; return old; }
+        const_iterator& operator-- ()
+            { --it; return *this; }
+        const_iterator operator-- (int)
+            { const_iterator old = *this; --it; return old; }
+        bool operator== (const const_iterator& rhs) const
+            { return it == rhs.it; }
+        bool operator!= (const const_iterator& rhs) const
+            { return it != rhs.it; }
+    private:
+        Entries_t::const_iterator it;
+    };
+
+    People_directory() : slot_bitsets(new Slot_bitsets), ids_in_order(true), sorted(true) {}
+    People_directory(const People_directory&) = delete;
+    People_directory& operator= (const People_directory&) = delete;
+
+    // The people in last name order.
+    const_iterator begin() const
+        { sort_people(); return const_iterator(people.begin()); }
+    const_iterator end() const
+        { sort_people(); return const_iterator(people.end()); }
+
+    std::size_t size() const
+        { return people.size(); }
+    bool empty() const
+        { return people.empty(); }
+
+    // Returns the person with the last name, or nullptr if there is none.
+    Person* find(const std::string& lastname) const;
+
+    // Returns the first person whose last name is greater than the specified one.
+    const_iterator upper_bound(const std::string& lastname) const;
+
+    // Returns the range of people whose last name starts with the prefix.
+    std::pair<const_iterator, const_iterator> prefix_range(const std::string& prefix) const;
+
+    // Returns the people who have a commitment at the time, in last name order.
+    std::vector<Person*> find_people_at(int time);
+
+    // Add the person; returns false, without adding them, if there is already
+    // a person with their last name.
+    bool insert(Person* person);
+
+    // Remove the person, if they are in the directory. They are not deleted.
+    void erase(Person* person);
+
+    // Remove all people. They are not deleted, but are no longer kept in the
+    // directory's slot bitsets, so they must be deleted before their commitments change.
+    void clear();
+
+    void swap(People_directory& other);
+
+private:
+    // a table position: the person there, or nullptr, and the hash of their last name
+    struct Slot {
+        Person* person;
+        std::size_t hash;
+    };
+
+    // Returns the key of a last name: its first key_size_c bytes, most significant
+    // first, padded with zero bytes.
+    static std::uint64_t name_key(const std::string& lastname);
+    // Compares the first length characters of the entry's last name with the
+    // name, whose key is specified, as std::string::compare does.
+    static int compare_name(const Entry& entry, const std::string& name, std::uint64_t key, std::size_t length);
+    // orders entries by last name
+    static bool entry_less(const Entry& lhs, const Entry& rhs);
+
+    // Returns the table position holding the person with the last name, whose
+    // hash is specified, or the empty one ending its probe sequence.
+    std::size_t find_slot(const std::string& lastname, std::size_t hash) const;
+    // Rebuild the table with the specified number of positions, a power of two.
+    void rebuild_table(std::size_t capacity);
+    // Sort the people into last name order if they are not.
+    void sort_people() const;
+    // Give the people new ids in last name order if their ids are not.
+    void renumber_people();
+
+    std::vector<Slot> table;
+    // the people's committed time slots, and the person with each id; the bitsets
+    // are on the heap so that the people keep theirs when directories are swapped.
+    std::unique_ptr<Slot_bitsets> slot_bitsets;
+    std::vector<Person*> people_by_id;
+    std::atomic<bool> ids_in_order;
+    // the people, in last name order if sorted is set
+    mutable Entries_t people;
+    mutable std::atomic<bool> sorted;
+    mutable std::mutex sort_mutex;
+};
+
+#endif
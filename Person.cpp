@@ -1,11 +1,17 @@
 #include "Person.h"
+#include "Change_feed.h"
+#include "Dated_meeting.h"
 #include "Meeting.h"
+#include "Slot_bitsets.h"
 #include <algorithm>
-#include <iostream>
+#include <ostream>
 
 using namespace std;
 
-Person::Person(ifstream& is)
+Person::Person(ifstream& is) :
+    committed_slots(0),
+    slot_bitsets(nullptr),
+    slot_id(0)
 {
     is >> firstname >> lastname >> phoneno;
     file_invalid_data_check(is);
@@ -19,102 +25,201 @@ void Person::save(ostream& os) const
 void Person::add_commitment(int room_number, const Meeting* meeting)
 {
     // check for commitment conflicts before adding a new commitment.
-    if (has_commitment_conflict(meeting->get_time()))
+    if (has_commitment_conflict(meeting->get_start(), meeting->get_end()))
     {
         throw Error("Person is already committed at that time!");
     }
+    agenda.insert(first_ending_after(meeting->get_start()),
+            Commitment{meeting->get_start(), meeting->get_end(), room_number, meeting});
+    unsigned int slots = span_slots(meeting->get_start(), meeting->get_end());
+    committed_slots |= slots;
+    for (int slot = 0; slot_bitsets && slot < num_time_slots_c; ++slot)
+    {
+        if (slots & (1u << slot))
+        {
+            slot_bitsets->set(slot, slot_id);
+        }
+    }
+    record_person_change(lastname);
+}
 
-    auto commitment_it = commitments.find(room_number);
-    // if a room does not exist in the commitment map, create
-    // a new entry for it.
-    if (commitment_it  == commitments.end())
+void Person::add_dated_commitment(Dated_meeting* meeting)
+{
+    if (dated_commitments.has_conflict(*meeting, false))
     {
-        commitments.emplace(
-            make_pair(room_number, set<const Meeting*, Less_than_ptr<const Meeting*>>{meeting}));
-        return;
+        throw Error("Person is already committed at that time!");
     }
+    dated_commitments.insert(meeting);
+    record_person_change(lastname);
+}
 
-    // insert a meeting to the commited room if its key already
-    // exists in the map.
-    commitment_it->second.insert(meeting);
+void Person::remove_dated_commitment(const Dated_meeting* meeting)
+{
+    dated_commitments.erase(meeting);
+    record_person_change(lastname);
+}
 
+void Person::attach_slot_bitsets(Slot_bitsets* slot_bitsets_, size_t slot_id_)
+{
+    slot_bitsets = slot_bitsets_;
+    slot_id = slot_id_;
+    for (int slot = 0; slot_bitsets && slot < num_time_slots_c; ++slot)
+    {
+        if (committed_slots & (1u << slot))
+        {
+            slot_bitsets->set(slot, slot_id);
+        }
+    }
 }
 
-bool Person::remove_commitment(int room_number, int meeting_time)
+bool Person::has_commitment_conflict(int start, int end, const Meeting* except) const
 {
-    auto room_commitment_it = commitments.find(room_number);
-    if (room_commitment_it == commitments.end())
+    if (!(committed_slots & span_slots(start, end)))
     {
-        // person is not commited to room so return false.
         return false;
     }
+    return overlaps(start, end, except);
+}
+
+Person::Agenda_t::const_iterator Person::first_ending_after(int minute) const
+{
+    return upper_bound(agenda.begin(), agenda.end(), minute,
+            [](int minute, const Commitment& commitment){ return minute < commitment.end; });
+}
 
-    Meeting probe(meeting_time);
-    auto meeting_it = room_commitment_it->second.find(&probe);
-    if (meeting_it == room_commitment_it->second.end())
+bool Person::overlaps(int start, int end, const Meeting* except) const
+{
+    // the overlapping commitments are those from the first ending after the start
+    // up to the first starting at or after the end.
+    for (auto commitment_it = first_ending_after(start);
+            commitment_it != agenda.end() && commitment_it->start < end; ++commitment_it)
+    {
+        if (commitment_it->meeting != except)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Person::Agenda_t::const_iterator Person::find_commitment(int room_number, int time) const
+{
+    if (!(committed_slots & slot_bit(time)))
+    {
+        return agenda.end();
+    }
+    // a room has at most one meeting starting in each hour, but the person may
+    // have several commitments starting in it, in different rooms.
+    int hour_end = time_minute(time) + minutes_per_slot_c;
+    for (auto commitment_it = lower_bound(agenda.begin(), agenda.end(), time_minute(time),
+                [](const Commitment& commitment, int minute){ return commitment.start < minute; });
+            commitment_it != agenda.end() && commitment_it->start < hour_end; ++commitment_it)
+    {
+        if (commitment_it->room_number == room_number)
+        {
+            return commitment_it;
+        }
+    }
+    return agenda.end();
+}
+
+bool Person::has_commitment(int room_number, int time) const
+{
+    return find_commitment(room_number, time) != agenda.end();
+}
+
+bool Person::remove_commitment(int room_number, int meeting_time)
+{
+    auto commitment_it = find_commitment(room_number, meeting_time);
+    if (commitment_it == agenda.end())
     {
-        // person not committed to specified meeting_it time
-        // in the room.
         return false;
     }
 
-    room_commitment_it->second.erase(meeting_it);
-    // remove room from map if there are no committed
-    // meeting_its in it.
-    if (room_commitment_it->second.empty())
+    int start = commitment_it->start, end = commitment_it->end;
+    agenda.erase(commitment_it);
+    // the slots of the commitment stay committed if another commitment is in them.
+    for (int slot = start / minutes_per_slot_c; slot * minutes_per_slot_c < end; ++slot)
     {
-        commitments.erase(room_commitment_it);
+        if (!overlaps(slot * minutes_per_slot_c, (slot + 1) * minutes_per_slot_c))
+        {
+            committed_slots &= ~(1u << slot);
+            if (slot_bitsets)
+            {
+                slot_bitsets->reset(slot, slot_id);
+            }
+        }
     }
+    record_person_change(lastname);
     return true;
 }
 
-void Person::remove_room_commitments(int room_number)
+void Person::clear_Commitments()
 {
-    auto room_committed = commitments.find(room_number);
-    // remove a committed room from the map of commitments.
-    // What this means is we are no longer committed to any
-    // of the meetings in the room that is removed.
-    if (room_committed != commitments.end())
+    if (!dated_commitments.empty())
+    {
+        dated_commitments.clear();
+        record_person_change(lastname);
+    }
+    if (!agenda.empty())
     {
-        commitments.erase(room_committed);
+        for (int slot = 0; slot_bitsets && slot < num_time_slots_c; ++slot)
+        {
+            slot_bitsets->reset(slot, slot_id);
+        }
+        agenda.clear();
+        committed_slots = 0;
+        record_person_change(lastname);
     }
 }
 
-void Person::print_commitment() const
+void Person::print_commitment(ostream& os) const
 {
-    if (commitments.empty())
+    if (agenda.empty())
     {
-        cout << "No commitments" << endl;
+        print_no_commitments(os);
         return;
     }
-    // go through each key in the commitments map (room number)
-    for_each(commitments.begin(), commitments.end(),
-            [](Commitments_t::value_type room_meet_pair)
+    for_each_commitment([&os](int room_number, const Meeting* meeting)
             {
-                // go through each meeting in the set of meetings for the room
-                // and print the commitments
-                for_each(room_meet_pair.second.begin(), room_meet_pair.second.end(),
-                    [&room_meet_pair](const Meeting* meeting)
-                    {
-                        cout << "Room:" << room_meet_pair.first
-                        << " Time: " << meeting->get_time()
-                        << " Topic: " << meeting->get_topic() << endl;
-                    });
+                ::print_commitment(os, room_number, meeting->get_start(), meeting->get_duration(), meeting->get_topic());
             });
-
 }
 
-bool Person::has_commitment_conflict(int time) const
+void Person::for_each_commitment(function<void(int, const Meeting*)> func) const
 {
-    // go through each key in the commitments map (room number)
-    return any_of(commitments.begin(), commitments.end(),
-            [&time](Commitments_t::value_type room_meet_pair)
+    // commitments are listed by room, then by time. The agenda is in time order, so
+    // each pass lists the commitments in the lowest room after the last one listed,
+    // and finds the room to list next; a person has few rooms, and no memory is needed.
+    int room_number = 0;
+    for (bool more = !agenda.empty(); more; )
+    {
+        int next_room_number = room_number;
+        more = false;
+        for (const Commitment& commitment : agenda)
+        {
+            if (commitment.room_number == room_number)
             {
-                // check if any of the meetings in the room conflict with the provided time.
-                return any_of(room_meet_pair.second.begin(), room_meet_pair.second.end(),
-                    [&time](const Meeting* meeting)
-                    {return meeting->get_time() == time;});
-            });
+                func(room_number, commitment.meeting);
+            }
+            else if (commitment.room_number > room_number && (!more || commitment.room_number < next_room_number))
+            {
+                next_room_number = commitment.room_number;
+                more = true;
+            }
+        }
+        room_number = next_room_number;
+    }
+}
+
+void Person::for_each_commitment_after(int time, function<bool(int, const Meeting*)> func) const
+{
+    // the commitments later than the time are those starting after its hour.
+    int first_minute = time ? time_minute(time) + minutes_per_slot_c : 0;
+    for (auto commitment_it = lower_bound(agenda.begin(), agenda.end(), first_minute,
+                [](const Commitment& commitment, int minute){ return commitment.start < minute; });
+            commitment_it != agenda.end() && func(commitment_it->room_number, commitment_it->meeting);
+            ++commitment_it);
 }
 
 ostream& operator<< (ostream& os, const Person& person)
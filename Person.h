@@ -2,21 +2,29 @@
 #define PERSON_H
 
 #include "Utility.h"
+#include "Horizon.h"
+#include <cstddef>
 #include <fstream>
+#include <functional>
 #include <string>
-#include <map>
-#include <set>
+#include <vector>
 
+class Dated_meeting;
 class Meeting;
+class Slot_bitsets;
 
 class Person {
 public:
     Person(const std::string& firstname_, const std::string& lastname_, const std::string& phoneno_) :
         firstname(firstname_),
         lastname(lastname_),
-        phoneno(phoneno_) {}
+        phoneno(phoneno_),
+        committed_slots(0),
+        slot_bitsets(nullptr),
+        slot_id(0) {}
     // construct a Person object with only a lastname
-    Person(const std::string& lastname_) : lastname(lastname_) {}
+    Person(const std::string& lastname_) :
+        lastname(lastname_), committed_slots(0), slot_bitsets(nullptr), slot_id(0) {}
 
     /* *** Disallow all forms of copy/move construction or assignment */
     // These declarations help ensure that Person objects are unique,
@@ -33,7 +41,7 @@ public:
     Person(std::ifstream& is);
     
     // Accessors
-    std::string get_lastname() const
+    const std::string& get_lastname() const
         { return lastname; }
     
     // Write a Person's data to a stream in save format with final endl.
@@ -49,19 +57,62 @@ public:
     // during a reschedule.
     bool remove_commitment(int room_number, int meeting_time);
 
-    // prints the commitments for this Person.
-    void print_commitment() const;
+    // prints the commitments for this Person to the stream.
+    void print_commitment(std::ostream& os) const;
 
-    // removes all commitments for this person for the given room number.
-    void remove_room_commitments(int room_number);
+    // Call the function with the room number and meeting of each commitment,
+    // in the order they are printed.
+    void for_each_commitment(std::function<void(int room_number, const Meeting* meeting)> func) const;
 
-    // clears all the commitments for this person.
-    void clear_Commitments()
-        {commitments.clear();}
+    // Call the function with the room number and meeting of each commitment later in
+    // the day than the time (or of all commitments if the time is 0), in time order,
+    // until it returns false.
+    void for_each_commitment_after(int time, std::function<bool(int room_number, const Meeting* meeting)> func) const;
 
-    // Function that checks for a commitment conflict given a meeting time.
-    // Returns true if a commitment conflict was found and false if it was not found.
-    bool has_commitment_conflict(int time) const;
+    // Adds a commitment to the dated meeting. Throws an error if the person is
+    // committed to another dated meeting at some of the same minutes on a date it occurs on.
+    void add_dated_commitment(Dated_meeting* meeting);
+
+    // Removes the commitment to the dated meeting, if there is one.
+    void remove_dated_commitment(const Dated_meeting* meeting);
+
+    // Returns true if the person is committed to a dated meeting other than the
+    // except one at some of the same minutes on a date the meeting occurs on.
+    bool has_dated_commitment_conflict(const Dated_meeting& meeting, const Dated_meeting* except = nullptr) const
+        { return dated_commitments.has_conflict(meeting, false, except); }
+
+    // Call the function with the date and meeting of each occurrence of the dated
+    // meetings the person is committed to from first_date to last_date, in date and time order.
+    void for_each_dated_commitment(int first_date, int last_date,
+            std::function<void(int date, const Dated_meeting* meeting)> func) const
+        { dated_commitments.for_each_occurrence(first_date, last_date, func); }
+
+    // Returns true if the person is committed to any meeting. The commitments are
+    // kept consistent with the participants of the meetings, so this is true
+    // exactly when the person is a participant in a meeting.
+    bool has_commitments() const
+        { return !agenda.empty() || !dated_commitments.empty(); }
+
+    // Returns true if the person is committed to the meeting at the time in the room.
+    bool has_commitment(int room_number, int time) const;
+
+    // Returns the slots the person has commitments in, with bit time_slot(t) set
+    // if there is a commitment at any time in the hour from t.
+    unsigned int get_committed_slots() const
+        { return committed_slots; }
+
+    // Returns the number of meetings this person is committed to.
+    int get_number_commitments() const
+        { return static_cast<int>(agenda.size()); }
+
+    // clears all the commitments for this person, dated ones included.
+    void clear_Commitments();
+
+    // Function that checks for a commitment conflict given the minutes of the day
+    // a meeting would start and end at (see Meeting::get_start); a commitment to the
+    // except meeting does not conflict. Returns true if a commitment conflict was
+    // found and false if it was not found.
+    bool has_commitment_conflict(int start, int end, const Meeting* except = nullptr) const;
 
     // This operator defines the order relation between Persons, based just on the last name
     bool operator< (const Person& rhs) const
@@ -73,14 +124,53 @@ public:
     friend std::ostream& operator<< (std::ostream& os, const Person* person);
 
 private:
+    // the directory gives the person their id in the directory's slot bitsets.
+    friend class People_directory;
+
+    // Mark the person's committed slots in the bitsets under the id, or stop
+    // marking them if the bitsets are nullptr, and keep them marked as the
+    // commitments change.
+    void attach_slot_bitsets(Slot_bitsets* slot_bitsets_, std::size_t slot_id_);
+
     std::string firstname;
     std::string lastname;
     std::string phoneno;
-    // map of integers(representing room numbers) to vectors of meetings
-    // corresponding to meetings for the key value
-    // map is ordered by room number
-    using Commitments_t = std::map<int, std::set<const Meeting*, Less_than_ptr<const Meeting*>>>;
-    Commitments_t commitments;
+    // a commitment to the meeting in the room, which takes the minutes of the day
+    // from start up to (not including) end
+    struct Commitment {
+        int start;
+        int end;
+        int room_number;
+        const Meeting* meeting;
+    };
+    // the commitments in time order. They cannot overlap, so they are in order of
+    // end as well as start, and those overlapping any span of minutes are found by
+    // one binary search; the agenda is a vector, so a person's commitments take no
+    // allocation of their own.
+    using Agenda_t = std::vector<Commitment>;
+    Agenda_t agenda;
+
+    // Returns the first commitment ending after the minute.
+    Agenda_t::const_iterator first_ending_after(int minute) const;
+    // Returns true if a commitment other than to the except meeting overlaps the
+    // minutes from start up to end.
+    bool overlaps(int start, int end, const Meeting* except = nullptr) const;
+    // Returns the commitment to the meeting in the room starting in the hour from
+    // the time, or agenda.end() if there is none.
+    Agenda_t::const_iterator find_commitment(int room_number, int time) const;
+    // bit time_slot(t) is set if there is a commitment at any time in the hour
+    // from t, so that most meetings are found not to conflict without a search.
+    unsigned int committed_slots;
+
+    static unsigned int slot_bit(int time)
+        { return 1u << time_slot(time); }
+
+    // the commitments to dated meetings, which are apart from those of the day.
+    Horizon dated_commitments;
+
+    // the bitsets the committed slots are marked in, or nullptr, and the id there
+    Slot_bitsets* slot_bitsets;
+    std::size_t slot_id;
 };
 
 // output firstname, lastname, phoneno with one separating space, NO endl
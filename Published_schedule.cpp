@@ -0,0 +1,729 @@
+#include "Published_schedule.h"
+#include "Dated_meeting.h"
+#include "Meeting.h"
+#include "People_directory.h"
+#include "Person.h"
+#include "Slot_finder.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+using namespace std;
+
+// approximate memory used by the contents of a string, beyond the string object.
+static size_t string_bytes(const string& s)
+{
+    return s.capacity() + 1;
+}
+
+Published_schedule::Published_schedule(Epoch_domain& domain) :
+    num_versions(0),
+    version_bytes(0),
+    retired(domain)
+{
+    publish(room_index, 0, Room_index_t(), 0);
+    publish(people_index, 0, People_index_t(), 0);
+}
+
+Published_schedule::~Published_schedule()
+{
+    for (Room_entry* entry : *room_index.latest())
+    {
+        delete entry;
+    }
+    for (Person_entry* entry : *people_index.latest())
+    {
+        delete entry;
+    }
+    for_each(removed_rooms.begin(), removed_rooms.end(),
+            [](const Removed_entry<Room_entry>& removed){ delete removed.entry; });
+    for_each(removed_people.begin(), removed_people.end(),
+            [](const Removed_entry<Person_entry>& removed){ delete removed.entry; });
+    retired.clear();
+}
+
+bool Published_schedule::is_read_command(const string& cmd)
+{
+    return cmd == "pi" || cmd == "pc" || cmd == "pr" || cmd == "pm" ||
+        cmd == "ps" || cmd == "pg" || cmd == "sd";
+}
+
+Published_schedule::Room_entry* Published_schedule::find_room_entry(const Room_index_t& index, int room_number)
+{
+    auto entry_it = lower_bound(index.begin(), index.end(), room_number,
+            [](const Room_entry* entry, int number){ return entry->room_number < number; });
+    return (entry_it == index.end() || (*entry_it)->room_number != room_number) ? nullptr : *entry_it;
+}
+
+Published_schedule::Person_entry* Published_schedule::find_person_entry(const People_index_t& index, const string& lastname)
+{
+    auto entry_it = lower_bound(index.begin(), index.end(), lastname,
+            [](const Person_entry* entry, const string& name){ return entry->lastname < name; });
+    return (entry_it == index.end() || (*entry_it)->lastname != lastname) ? nullptr : *entry_it;
+}
+
+// the live room with the number, or nullptr if there is none.
+static const Room* find_live_room(const Room_t& rooms, int room_number)
+{
+    return rooms.find(room_number);
+}
+
+// the live person with the last name, or nullptr if there is none.
+static const Person* find_live_person(const People_t& people, const string& lastname)
+{
+    return people.find(lastname);
+}
+
+// reads the optional integer argument of a command, returning 0 if it cannot be read.
+static int read_int_argument(istream& is)
+{
+    int value = 0;
+    is >> value;
+    return is ? value : 0;
+}
+
+void Published_schedule::update(const string& command, const Room_t& rooms, const People_t& people,
+        uint64_t seq, uint64_t horizon)
+{
+    istringstream is(command);
+    string cmd = read_command_name(is);
+
+    // with the near option, the room the meeting went to is not in the command.
+    if ((cmd == "am" || cmd == "rm") && has_nearest_option(command))
+    {
+        rebuild(rooms, people, seq, horizon);
+        return;
+    }
+    if (is_read_command(cmd) || cmd == "pa" || cmd == "pt" || cmd == "pf" || cmd == "qu" ||
+            cmd == "fr" || cmd == "br" || cmd == "bp" || cmd == "fs" || cmd == "fa" || cmd == "fc" || cmd == "pd" || cmd == "pe" ||
+            cmd == "wr" || cmd == "wp" || cmd == "wc" || cmd == "wu")
+    {
+        // nothing changed; the change feed is not part of the published copy
+    }
+    // commands that change one room; the commitments to dated meetings are not published.
+    else if (cmd == "am" || cmd == "at" || cmd == "ad" || cmd == "ac" || cmd == "ae" || cmd == "de" ||
+            cmd == "dd" || cmd == "dx" || cmd == "rc")
+    {
+        publish_room(rooms, read_int_argument(is), seq);
+    }
+    else if (cmd == "rd")
+    {
+        string date;
+        int room_number = read_int_argument(is);
+        is >> date;
+        read_int_argument(is);
+        publish_room(rooms, room_number, seq);
+        publish_room(rooms, read_int_argument(is), seq);
+    }
+    // commands that change one room and one person.
+    else if (cmd == "ap" || cmd == "dp")
+    {
+        int room_number = read_int_argument(is);
+        read_int_argument(is);
+        string lastname;
+        is >> lastname;
+        publish_room(rooms, room_number, seq);
+        publish_person(people, lastname, seq);
+    }
+    // commands that change rooms and the commitments of a meeting's participants.
+    else if (cmd == "dm" || cmd == "rm" || cmd == "dr")
+    {
+        int room_number = read_int_argument(is);
+        int time = (cmd == "dr") ? 0 : read_int_argument(is);
+        int new_room_number = read_int_argument(is);
+        vector<string> participants = latest_participants(room_number, time);
+        if (cmd == "dr")
+        {
+            publish_room_index(rooms, room_number, seq);
+        }
+        else
+        {
+            publish_room(rooms, room_number, seq);
+            publish_room(rooms, new_room_number, seq);
+        }
+        for (const string& lastname : participants)
+        {
+            publish_person(people, lastname, seq);
+        }
+    }
+    else if (cmd == "ar")
+    {
+        publish_room_index(rooms, read_int_argument(is), seq);
+    }
+    else if (cmd == "ai" || cmd == "di")
+    {
+        string firstname, lastname;
+        is >> firstname;
+        lastname = firstname;
+        if (cmd == "ai")
+        {
+            is >> lastname;
+        }
+        publish_people_index(people, lastname, seq);
+    }
+    // everything else may change anything.
+    else
+    {
+        rebuild(rooms, people, seq, horizon);
+        return;
+    }
+    collect_garbage(horizon);
+}
+
+template<typename T>
+void Published_schedule::publish(Version_chain<T>& chain, uint64_t seq, T&& data, size_t data_bytes)
+{
+    const Version_node* older = chain.latest_node();
+    const Version_node* newer = chain.publish(seq, move(data), data_bytes);
+    ++num_versions;
+    version_bytes += newer->bytes;
+    if (older)
+    {
+        superseded.push_back(Superseded{seq, newer});
+    }
+}
+
+vector<string> Published_schedule::latest_participants(int room_number, int time) const
+{
+    vector<string> lastnames;
+    const Room_entry* entry = find_room_entry(*room_index.latest(), room_number);
+    if (!entry)
+    {
+        return lastnames;
+    }
+    for (const Published_meeting& meeting : entry->versions.latest()->meetings)
+    {
+        if (time == 0 || meeting.time == time)
+        {
+            for (const Person_entry* participant : meeting.participants)
+            {
+                lastnames.push_back(participant->lastname);
+            }
+        }
+    }
+    return lastnames;
+}
+
+Published_schedule::Room_version Published_schedule::make_room_version(const Room& room, size_t& bytes) const
+{
+    const People_index_t& people = *people_index.latest();
+    Room_version version{Meetings_t(), room.get_number_Dated_meetings(), string(),
+        room.get_capacity(), room.get_attributes()};
+    Meetings_t& meetings = version.meetings;
+    room.for_each_Meeting([&people, &meetings, &bytes](const Meeting* meeting)
+            {
+                Published_meeting published{meeting->get_time(), meeting->get_start(), meeting->get_duration(),
+                    meeting->get_topic(), {}};
+                meeting->for_each_participant([&people, &published](const Person* person)
+                        {
+                            published.participants.push_back(find_person_entry(people, person->get_lastname()));
+                        });
+                bytes += sizeof(Published_meeting) + string_bytes(published.topic) +
+                    published.participants.capacity() * sizeof(const Person_entry*);
+                meetings.push_back(move(published));
+            });
+    if (room.has_Dated_meetings())
+    {
+        ostringstream text;
+        room.for_each_Dated_meeting(bind(&Dated_meeting::save, placeholders::_1, ref(text)));
+        version.dated_text = text.str();
+        bytes += string_bytes(version.dated_text);
+    }
+    return version;
+}
+
+Published_schedule::Commitments_t Published_schedule::make_commitments(const Person* person, size_t& bytes)
+{
+    Commitments_t commitments;
+    person->for_each_commitment([&commitments, &bytes](int room_number, const Meeting* meeting)
+            {
+                commitments.push_back(Published_commitment{room_number, meeting->get_start(), meeting->get_duration(),
+                        meeting->get_topic()});
+                bytes += sizeof(Published_commitment) + string_bytes(commitments.back().topic);
+            });
+    return commitments;
+}
+
+Published_schedule::Room_entry* Published_schedule::make_room_entry(const Room& room, uint64_t seq)
+{
+    Room_entry* entry = new Room_entry(room.get_room_number());
+    size_t bytes = 0;
+    Room_version version = make_room_version(room, bytes);
+    publish(entry->versions, seq, move(version), bytes);
+    return entry;
+}
+
+Published_schedule::Person_entry* Published_schedule::make_person_entry(const Person* person, uint64_t seq)
+{
+    ostringstream text;
+    text << *person;
+    Person_entry* entry = new Person_entry(person->get_lastname(), text.str());
+    size_t bytes = string_bytes(entry->text);
+    Commitments_t commitments = make_commitments(person, bytes);
+    publish(entry->commitments, seq, move(commitments), bytes);
+    return entry;
+}
+
+void Published_schedule::publish_room(const Room_t& rooms, int room_number, uint64_t seq)
+{
+    Room_entry* entry = find_room_entry(*room_index.latest(), room_number);
+    const Room* room = find_live_room(rooms, room_number);
+    if (!entry || !room)
+    {
+        return;
+    }
+    size_t bytes = 0;
+    Room_version version = make_room_version(*room, bytes);
+    publish(entry->versions, seq, move(version), bytes);
+}
+
+void Published_schedule::publish_person(const People_t& people, const string& lastname, uint64_t seq)
+{
+    Person_entry* entry = find_person_entry(*people_index.latest(), lastname);
+    const Person* person = find_live_person(people, lastname);
+    if (!entry || !person)
+    {
+        return;
+    }
+    size_t bytes = 0;
+    Commitments_t commitments = make_commitments(person, bytes);
+    publish(entry->commitments, seq, move(commitments), bytes);
+}
+
+void Published_schedule::publish_room_index(const Room_t& rooms, int room_number, uint64_t seq)
+{
+    const Room_index_t& old_index = *room_index.latest();
+    Room_entry* entry = find_room_entry(old_index, room_number);
+    const Room* room = find_live_room(rooms, room_number);
+    // only the addition or removal of the room changes the index.
+    if (!entry == !room)
+    {
+        return;
+    }
+    Room_index_t new_index(old_index);
+    if (room)
+    {
+        entry = make_room_entry(*room, seq);
+        new_index.insert(lower_bound(new_index.begin(), new_index.end(), entry,
+                    [](const Room_entry* e1, const Room_entry* e2){ return e1->room_number < e2->room_number; }),
+                entry);
+    }
+    else
+    {
+        new_index.erase(find(new_index.begin(), new_index.end(), entry));
+        removed_rooms.push_back(Removed_entry<Room_entry>{seq, entry});
+    }
+    size_t bytes = new_index.capacity() * sizeof(Room_entry*);
+    publish(room_index, seq, move(new_index), bytes);
+}
+
+void Published_schedule::publish_people_index(const People_t& people, const string& lastname, uint64_t seq)
+{
+    const People_index_t& old_index = *people_index.latest();
+    Person_entry* entry = find_person_entry(old_index, lastname);
+    const Person* person = find_live_person(people, lastname);
+    // only the addition or removal of the person changes the index.
+    if (!entry == !person)
+    {
+        return;
+    }
+    People_index_t new_index(old_index);
+    if (person)
+    {
+        entry = make_person_entry(person, seq);
+        new_index.insert(lower_bound(new_index.begin(), new_index.end(), entry,
+                    [](const Person_entry* e1, const Person_entry* e2){ return e1->lastname < e2->lastname; }),
+                entry);
+    }
+    else
+    {
+        new_index.erase(find(new_index.begin(), new_index.end(), entry));
+        removed_people.push_back(Removed_entry<Person_entry>{seq, entry});
+    }
+    size_t bytes = new_index.capacity() * sizeof(Person_entry*);
+    publish(people_index, seq, move(new_index), bytes);
+}
+
+void Published_schedule::rebuild(const Room_t& rooms, const People_t& people, uint64_t seq, uint64_t horizon)
+{
+    // every entry of the previous version goes away at seq.
+    for (Room_entry* entry : *room_index.latest())
+    {
+        removed_rooms.push_back(Removed_entry<Room_entry>{seq, entry});
+    }
+    for (Person_entry* entry : *people_index.latest())
+    {
+        removed_people.push_back(Removed_entry<Person_entry>{seq, entry});
+    }
+
+    // people first, since the meetings refer to the person entries.
+    People_index_t new_people;
+    for (const Person* person : people)
+    {
+        new_people.push_back(make_person_entry(person, seq));
+    }
+    size_t people_bytes = new_people.capacity() * sizeof(Person_entry*);
+    publish(people_index, seq, move(new_people), people_bytes);
+
+    Room_index_t new_rooms;
+    for (const Room& room : rooms)
+    {
+        new_rooms.push_back(make_room_entry(room, seq));
+    }
+    size_t room_bytes = new_rooms.capacity() * sizeof(Room_entry*);
+    publish(room_index, seq, move(new_rooms), room_bytes);
+
+    collect_garbage(horizon);
+}
+
+void Published_schedule::collect_garbage(uint64_t horizon)
+{
+    // versions older than a superseding one are visible only to snapshots before it.
+    while (!superseded.empty() && superseded.front().seq <= horizon)
+    {
+        retire_versions(Version_chain<Room_index_t>::remove_older(superseded.front().newer));
+        superseded.pop_front();
+    }
+    // entries removed at seq are visible only to snapshots before seq; all their
+    // older versions have been unlinked above, since they were superseded earlier.
+    while (!removed_rooms.empty() && removed_rooms.front().seq <= horizon)
+    {
+        retire_entry(removed_rooms.front().entry);
+        removed_rooms.pop_front();
+    }
+    while (!removed_people.empty() && removed_people.front().seq <= horizon)
+    {
+        retire_entry(removed_people.front().entry);
+        removed_people.pop_front();
+    }
+    retired.reclaim();
+}
+
+void Published_schedule::retire_versions(const Version_node* node)
+{
+    while (node)
+    {
+        const Version_node* older = node->older.load();
+        --num_versions;
+        version_bytes -= node->bytes;
+        retired.retire(node);
+        node = older;
+    }
+}
+
+template<typename T>
+void Published_schedule::retire_entry(const T* entry)
+{
+    // the entry's chain deletes its versions along with it.
+    const Version_node* node = entry->latest_node();
+    while (node)
+    {
+        --num_versions;
+        version_bytes -= node->bytes;
+        node = node->older.load();
+    }
+    retired.retire(entry);
+}
+
+void Published_schedule::print_versions(ostream& os) const
+{
+    os << "Published versions: " << num_versions << endl;
+    os << "Published version memory: " << version_bytes << " bytes" << endl;
+}
+
+void Published_schedule::execute_read(const string& command, uint64_t snapshot, ostream& os) const
+{
+    istringstream is(command);
+    string cmd = read_command_name(is);
+    try{
+        if (cmd == "pi")
+        {
+            print_individual(is, snapshot, os);
+        }
+        else if (cmd == "pc")
+        {
+            print_commitments(is, snapshot, os);
+        }
+        else if (cmd == "pr")
+        {
+            print_room(is, snapshot, os);
+        }
+        else if (cmd == "pm")
+        {
+            print_meeting(is, snapshot, os);
+        }
+        else if (cmd == "ps")
+        {
+            print_all_meetings(is, snapshot, os);
+        }
+        else if (cmd == "pg")
+        {
+            print_all_people(is, snapshot, os);
+        }
+        else if (cmd == "sd")
+        {
+            save(is, snapshot, os);
+        }
+        else
+        {
+            throw Error(invalid_command_message_c);
+        }
+    }
+    catch(Error& e)
+    {
+        os << e.msg << endl;
+    }
+}
+
+const Published_schedule::Person_entry& Published_schedule::read_person(istream& is, uint64_t snapshot) const
+{
+    string lastname;
+    is >> lastname;
+    const Person_entry* entry = find_person_entry(*people_index.at(snapshot), lastname);
+    if (!entry)
+    {
+        throw Error(no_person_message_c);
+    }
+    return *entry;
+}
+
+const Published_schedule::Room_entry& Published_schedule::read_room(istream& is, uint64_t snapshot) const
+{
+    int room_number = get_and_check_room_number(is);
+    const Room_entry* entry = find_room_entry(*room_index.at(snapshot), room_number);
+    if (!entry)
+    {
+        throw Error(no_room_number_message_c);
+    }
+    return *entry;
+}
+
+void Published_schedule::print_individual(istream& is, uint64_t snapshot, ostream& os) const
+{
+    os << read_person(is, snapshot).text << endl;
+}
+
+void Published_schedule::print_commitments(istream& is, uint64_t snapshot, ostream& os) const
+{
+    const Commitments_t& commitments = *read_person(is, snapshot).commitments.at(snapshot);
+    if (commitments.empty())
+    {
+        print_no_commitments(os);
+        return;
+    }
+    for (const Published_commitment& commitment : commitments)
+    {
+        print_commitment(os, commitment.room_number, commitment.start, commitment.duration, commitment.topic);
+    }
+}
+
+// print a published meeting in the format of the Meeting output operator.
+void Published_schedule::print_published_meeting(ostream& os, const Published_meeting& meeting)
+{
+    print_meeting_heading(os, meeting.start, meeting.duration, meeting.topic, !meeting.participants.empty());
+    for (const Person_entry* participant : meeting.participants)
+    {
+        os << participant->text << "\n";
+    }
+}
+
+// print a published room in the format of the Room output operator.
+void Published_schedule::print_published_room(ostream& os, const Room_entry& room, uint64_t snapshot)
+{
+    const Meetings_t& meetings = room.versions.at(snapshot)->meetings;
+    print_room_heading(os, room.room_number);
+    if (meetings.empty())
+    {
+        print_no_meetings(os);
+        return;
+    }
+    for (const Published_meeting& meeting : meetings)
+    {
+        print_published_meeting(os, meeting);
+    }
+}
+
+void Published_schedule::print_room(istream& is, uint64_t snapshot, ostream& os) const
+{
+    print_published_room(os, read_room(is, snapshot), snapshot);
+}
+
+void Published_schedule::print_meeting(istream& is, uint64_t snapshot, ostream& os) const
+{
+    const Room_entry& entry = read_room(is, snapshot);
+    int time = get_and_check_meeting_time(is);
+    const Meetings_t& meetings = entry.versions.at(snapshot)->meetings;
+    auto meeting_it = find_if(meetings.begin(), meetings.end(),
+            [time](const Published_meeting& meeting){ return meeting.time == time; });
+    if (meeting_it == meetings.end())
+    {
+        throw Error(no_meeting_at_time_message_c);
+    }
+    print_published_meeting(os, *meeting_it);
+}
+
+// print one page of ps in the same format as the ps command.
+void Published_schedule::print_meetings_page(int limit, const string& cursor, uint64_t snapshot, ostream& os) const
+{
+    int cursor_room = 0, cursor_time = 0;
+    if (!cursor.empty())
+    {
+        parse_room_cursor(cursor, cursor_room, cursor_time);
+    }
+    const Room_index_t& rooms = *room_index.at(snapshot);
+    print_list_heading(os, rooms.size(), "rooms");
+
+    int rows = 0, last_room = 0, last_time = 0;
+    bool more = false;
+    auto room_it = lower_bound(rooms.begin(), rooms.end(), cursor_room,
+            [](const Room_entry* entry, int number){ return entry->room_number < number; });
+    for (; room_it != rooms.end() && !more; ++room_it)
+    {
+        const Room_entry& room = **room_it;
+        const Meetings_t& meetings = room.versions.at(snapshot)->meetings;
+        // the cursor's room continues after the cursor's row.
+        bool resumed = !cursor.empty() && room.room_number == cursor_room;
+        if (meetings.empty())
+        {
+            if (resumed)
+            {
+                continue;
+            }
+            if (rows == limit)
+            {
+                more = true;
+                break;
+            }
+            print_published_room(os, room, snapshot);
+            ++rows;
+            last_room = room.room_number;
+            last_time = 0;
+            continue;
+        }
+        auto meeting_it = meetings.begin();
+        if (resumed && cursor_time)
+        {
+            meeting_it = upper_bound(meetings.begin(), meetings.end(), cursor_time,
+                    [](int time, const Published_meeting& meeting){ return Meeting(time) < Meeting(meeting.time); });
+        }
+        for (bool heading_printed = false; meeting_it != meetings.end(); ++meeting_it)
+        {
+            if (rows == limit)
+            {
+                more = true;
+                break;
+            }
+            if (!heading_printed)
+            {
+                print_room_heading(os, room.room_number);
+                heading_printed = true;
+            }
+            print_published_meeting(os, *meeting_it);
+            ++rows;
+            last_room = room.room_number;
+            last_time = meeting_it->time;
+        }
+    }
+    if (more)
+    {
+        print_page_cursor(os, last_room, last_time);
+    }
+}
+
+void Published_schedule::print_all_meetings(istream& is, uint64_t snapshot, ostream& os) const
+{
+    int limit;
+    string cursor;
+    if (read_page_arguments(is, limit, cursor))
+    {
+        print_meetings_page(limit, cursor, snapshot, os);
+        return;
+    }
+    const Room_index_t& rooms = *room_index.at(snapshot);
+    if (rooms.empty())
+    {
+        print_empty_list(os, "rooms");
+        return;
+    }
+    print_list_heading(os, rooms.size(), "rooms");
+    for (const Room_entry* room : rooms)
+    {
+        print_published_room(os, *room, snapshot);
+    }
+}
+
+void Published_schedule::print_all_people(istream& is, uint64_t snapshot, ostream& os) const
+{
+    const People_index_t& people = *people_index.at(snapshot);
+    int limit;
+    string cursor;
+    if (read_page_arguments(is, limit, cursor))
+    {
+        // one page, in the same format as the pg command.
+        print_list_heading(os, people.size(), "people");
+        auto person_it = cursor.empty() ? people.begin() : upper_bound(people.begin(), people.end(), cursor,
+                [](const string& name, const Person_entry* entry){ return name < entry->lastname; });
+        for (int rows = 0; person_it != people.end() && rows < limit; ++person_it, ++rows)
+        {
+            os << (*person_it)->text << endl;
+        }
+        if (person_it != people.end())
+        {
+            print_page_cursor(os, (*prev(person_it))->lastname);
+        }
+        return;
+    }
+    if (people.empty())
+    {
+        print_empty_list(os, "people");
+        return;
+    }
+    print_list_heading(os, people.size(), "people");
+    for (const Person_entry* person : people)
+    {
+        os << person->text << endl;
+    }
+}
+
+// writes the snapshot in the same format as the sd command.
+void Published_schedule::save(istream& is, uint64_t snapshot, ostream& os) const
+{
+    string filename;
+    is >> filename;
+
+    ofstream outfile(filename.c_str());
+    if(!outfile)
+    {
+        throw Error(file_cannot_open_message_c);
+    }
+
+    const People_index_t& people = *people_index.at(snapshot);
+    outfile << people.size() << endl;
+    for (const Person_entry* person : people)
+    {
+        outfile << person->text << endl;
+    }
+
+    const Room_index_t& rooms = *room_index.at(snapshot);
+    outfile << rooms.size() << endl;
+    for (const Room_entry* room : rooms)
+    {
+        const Room_version& version = *room->versions.at(snapshot);
+        const Meetings_t& meetings = version.meetings;
+        save_room_heading(outfile, room->room_number, meetings.size(), version.num_dated_meetings,
+            version.capacity, version.attributes);
+        for (const Published_meeting& meeting : meetings)
+        {
+            print_time_span(outfile, meeting.start, meeting.duration);
+            outfile << " " << meeting.topic << " " << meeting.participants.size() << endl;
+            for (const Person_entry* participant : meeting.participants)
+            {
+                outfile << participant->lastname << endl;
+            }
+        }
+        outfile << version.dated_text;
+    }
+
+    os << "Data saved" << endl;
+}
@@ -0,0 +1,181 @@
+#ifndef PUBLISHED_SCHEDULE_H
+#define PUBLISHED_SCHEDULE_H
+
+#include "Commands.h"
+#include "Epoch.h"
+#include "Version_chain.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* A Published_schedule is a multi-version, read-only copy of one schedule, so that
+reader threads can answer the read-only commands (pi, pc, pr, pm, ps, pg and sd)
+while the schedule's owning thread keeps applying changes.
+
+The copy consists of a room index (a sorted array of room entries), a people index
+(a sorted array of person entries), and for each room entry the array of its
+meetings and for each person entry the array of their commitments. The dated meetings
+of a room are kept as their save text, for sd. Each of these
+is a Version_chain whose versions are tagged with the sequence number of the
+command that created them: the schedule's owning thread executes command n and then
+publishes, as version n, only the arrays that the command can have changed.
+
+A reader reads as of a snapshot S, seeing exactly the state after the first S
+commands, no matter how many commands the writer has applied since; so a long read
+such as ps never holds up the writer and always sees a consistent schedule.
+Versions that no snapshot at or after the oldest one still needed (the horizon)
+can see are unlinked by the writer and retired to a Retire_list, to be deleted once
+no reader can be traversing them.
+*/
+
+class Published_schedule {
+public:
+    explicit Published_schedule(Epoch_domain& domain);
+    // Deletes all versions; no reader may be active.
+    ~Published_schedule();
+
+    Published_schedule(const Published_schedule&) = delete;
+    Published_schedule& operator= (const Published_schedule&) = delete;
+
+    // Returns true if the command is one of the reads answered by execute_read.
+    static bool is_read_command(const std::string& cmd);
+
+    /* Writer side, called only by the schedule's owning thread. */
+
+    // Publish version seq after the command text has been executed against the
+    // schedule, creating new versions only of what the command can change.
+    // No snapshot before horizon will be read any more.
+    void update(const std::string& command, const Room_t& rooms, const People_t& people,
+            std::uint64_t seq, std::uint64_t horizon);
+
+    // Publish all of the schedule as version seq.
+    void rebuild(const Room_t& rooms, const People_t& people, std::uint64_t seq, std::uint64_t horizon);
+
+    // Print the number of versions kept and the memory they use.
+    void print_versions(std::ostream& os) const;
+
+    /* Reader side, called inside an Epoch_guard of the domain. */
+
+    // Execute a read command from its text as of the snapshot, writing its output
+    // (or its error message) to the stream, exactly as the command would have
+    // after the first snapshot commands.
+    void execute_read(const std::string& command, std::uint64_t snapshot, std::ostream& os) const;
+
+private:
+    struct Published_commitment {
+        int room_number;
+        int start;
+        int duration;
+        std::string topic;
+    };
+    using Commitments_t = std::vector<Published_commitment>;
+
+    struct Person_entry {
+        Person_entry(const std::string& lastname_, const std::string& text_) :
+            lastname(lastname_), text(text_) {}
+        const std::string lastname;
+        // the person's data as written by the output operator, which is also the save format
+        const std::string text;
+        Version_chain<Commitments_t> commitments;
+        const Version_node* latest_node() const
+            { return commitments.latest_node(); }
+    };
+
+    struct Published_meeting {
+        // the meeting time it starts in, and its minutes (see Meeting::get_start)
+        int time;
+        int start;
+        int duration;
+        std::string topic;
+        std::vector<const Person_entry*> participants;
+    };
+    using Meetings_t = std::vector<Published_meeting>;
+
+    // a version of a room: its meetings, and its dated meetings (see Dated_meeting),
+    // which only sd reads, as their number and their text in save format.
+    struct Room_version {
+        Meetings_t meetings;
+        int num_dated_meetings;
+        std::string dated_text;
+        int capacity;
+        unsigned int attributes;
+    };
+
+    struct Room_entry {
+        explicit Room_entry(int room_number_) : room_number(room_number_) {}
+        const int room_number;
+        Version_chain<Room_version> versions;
+        const Version_node* latest_node() const
+            { return versions.latest_node(); }
+    };
+
+    using Room_index_t = std::vector<Room_entry*>;
+    using People_index_t = std::vector<Person_entry*>;
+
+    // A version that becomes invisible to every snapshot from seq onwards:
+    // the versions older than newer, or a whole room or person entry.
+    struct Superseded {
+        std::uint64_t seq;
+        const Version_node* newer;
+    };
+    template<typename T>
+    struct Removed_entry {
+        std::uint64_t seq;
+        const T* entry;
+    };
+
+    // helpers that find entries in an index version, returning nullptr if not found.
+    static Room_entry* find_room_entry(const Room_index_t& index, int room_number);
+    static Person_entry* find_person_entry(const People_index_t& index, const std::string& lastname);
+
+    // writer-side helpers
+    template<typename T>
+    void publish(Version_chain<T>& chain, std::uint64_t seq, T&& data, std::size_t data_bytes);
+    void publish_room(const Room_t& rooms, int room_number, std::uint64_t seq);
+    void publish_person(const People_t& people, const std::string& lastname, std::uint64_t seq);
+    void publish_room_index(const Room_t& rooms, int room_number, std::uint64_t seq);
+    void publish_people_index(const People_t& people, const std::string& lastname, std::uint64_t seq);
+    Room_entry* make_room_entry(const Room& room, std::uint64_t seq);
+    Person_entry* make_person_entry(const Person* person, std::uint64_t seq);
+    // Returns the data of a new version, adding its memory to bytes.
+    Room_version make_room_version(const Room& room, std::size_t& bytes) const;
+    static Commitments_t make_commitments(const Person* person, std::size_t& bytes);
+    // Returns the last names of the participants in the latest version of the meeting,
+    // or in all of the room's meetings if time is zero.
+    std::vector<std::string> latest_participants(int room_number, int time) const;
+    // Unlink and retire the versions that no snapshot at or after horizon can see.
+    void collect_garbage(std::uint64_t horizon);
+    void retire_versions(const Version_node* node);
+    template<typename T>
+    void retire_entry(const T* entry);
+
+    // reader-side helpers; each reads as of the snapshot
+    const Person_entry& read_person(std::istream& is, std::uint64_t snapshot) const;
+    const Room_entry& read_room(std::istream& is, std::uint64_t snapshot) const;
+    void print_individual(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void print_commitments(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void print_room(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void print_meeting(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void print_all_meetings(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void print_meetings_page(int limit, const std::string& cursor, std::uint64_t snapshot, std::ostream& os) const;
+    void print_all_people(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    void save(std::istream& is, std::uint64_t snapshot, std::ostream& os) const;
+    static void print_published_room(std::ostream& os, const Room_entry& room, std::uint64_t snapshot);
+    static void print_published_meeting(std::ostream& os, const Published_meeting& meeting);
+
+    Version_chain<Room_index_t> room_index;
+    Version_chain<People_index_t> people_index;
+    // garbage waiting for the horizon to pass, each in order of seq
+    std::deque<Superseded> superseded;
+    std::deque<Removed_entry<Room_entry>> removed_rooms;
+    std::deque<Removed_entry<Person_entry>> removed_people;
+    // number of versions in the chains, and their memory
+    int num_versions;
+    std::size_t version_bytes;
+    Retire_list retired;
+};
+
+#endif
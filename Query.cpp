@@ -0,0 +1,340 @@
+#include "Query.h"
+#include "Meeting.h"
+#include "People_directory.h"
+#include "Person.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// string literals
+const char* const invalid_query_message_c = "Invalid query!";
+
+// the conditions of a meetings query; a zero or empty value means any.
+struct Meeting_query {
+    int first_room = 1;
+    int last_room = INT_MAX;
+    int time = 0;
+    string topic;
+    vector<string> participants;
+};
+
+// the conditions of a people query.
+struct People_query {
+    string name;
+    // the number of commitments must compare to commitments as op ('=', '<' or '>') does.
+    char op = 0;
+    int commitments = 0;
+};
+
+// the number of rows a plan examined and returned.
+struct Row_counts {
+    int examined = 0;
+    int returned = 0;
+};
+
+// reads a value of the query, which must be present.
+static string read_value(istream& is)
+{
+    string value;
+    if (!(is >> value))
+    {
+        throw Error(invalid_query_message_c);
+    }
+    return value;
+}
+
+// reads a room number range of the form A..B.
+static void read_room_range(istream& is, Meeting_query& query)
+{
+    string range = read_value(is);
+    auto dots = range.find("..");
+    if (dots == string::npos)
+    {
+        throw Error(invalid_query_message_c);
+    }
+    istringstream first_is(range.substr(0, dots)), last_is(range.substr(dots + 2));
+    query.first_room = max(query.first_room, get_and_check_room_number(first_is));
+    query.last_room = min(query.last_room, get_and_check_room_number(last_is));
+}
+
+static Meeting_query read_meeting_conditions(istream& is)
+{
+    Meeting_query query;
+    string field;
+    while (is >> field)
+    {
+        string op = read_value(is);
+        if (field == "room" && op == "in")
+        {
+            read_room_range(is, query);
+        }
+        else if (op != "=")
+        {
+            throw Error(invalid_query_message_c);
+        }
+        else if (field == "room")
+        {
+            int room_number = get_and_check_room_number(is);
+            query.first_room = max(query.first_room, room_number);
+            query.last_room = min(query.last_room, room_number);
+        }
+        else if (field == "time")
+        {
+            int time = get_and_check_meeting_time(is);
+            // two different times cannot both match.
+            query.time = (query.time && query.time != time) ? -1 : time;
+        }
+        else if (field == "topic")
+        {
+            query.topic = read_value(is);
+        }
+        else if (field == "participant")
+        {
+            query.participants.push_back(read_value(is));
+        }
+        else
+        {
+            throw Error(invalid_query_message_c);
+        }
+        string conjunction;
+        if (is >> conjunction && conjunction != "and")
+        {
+            throw Error(invalid_query_message_c);
+        }
+    }
+    return query;
+}
+
+static People_query read_people_conditions(istream& is)
+{
+    People_query query;
+    string field;
+    while (is >> field)
+    {
+        string op = read_value(is);
+        if (field == "name" && op == "=")
+        {
+            query.name = read_value(is);
+        }
+        else if (field == "commitments" && (op == "=" || op == "<" || op == ">"))
+        {
+            query.op = op[0];
+            istringstream value_is(read_value(is));
+            if (!(value_is >> query.commitments))
+            {
+                throw Error(invalid_query_message_c);
+            }
+        }
+        else
+        {
+            throw Error(invalid_query_message_c);
+        }
+        string conjunction;
+        if (is >> conjunction && conjunction != "and")
+        {
+            throw Error(invalid_query_message_c);
+        }
+    }
+    return query;
+}
+
+// writes the meeting as a row if it passes the conditions that the access path has not applied.
+static void filter_meeting(ostream& os, const Meeting_query& query, const vector<const Person*>& participants,
+        int room_number, const Meeting* meeting, Row_counts& counts)
+{
+    ++counts.examined;
+    if (room_number < query.first_room || room_number > query.last_room ||
+            (query.time && meeting->get_time() != query.time) ||
+            (!query.topic.empty() && meeting->get_topic() != query.topic) ||
+            !all_of(participants.begin(), participants.end(),
+                bind(&Person::has_commitment, placeholders::_1, room_number, meeting->get_time())))
+    {
+        return;
+    }
+    ++counts.returned;
+    print_commitment(os, room_number, meeting->get_start(), meeting->get_duration(), meeting->get_topic());
+}
+
+static void query_meetings(MeetingData& meeting_data, istream& is, bool explain)
+{
+    Meeting_query query = read_meeting_conditions(is);
+    ostream& os = meeting_data.os;
+
+    // every named participant must exist for any meeting to match.
+    vector<const Person*> participants;
+    const Person* fewest_commitments = nullptr;
+    bool no_match = query.first_room > query.last_room || query.time < 0;
+    for (const string& lastname : query.participants)
+    {
+        const Person* person = meeting_data.people.find(lastname);
+        if (!person)
+        {
+            no_match = true;
+            break;
+        }
+        participants.push_back(person);
+        if (!fewest_commitments || person->get_number_commitments() < fewest_commitments->get_number_commitments())
+        {
+            fewest_commitments = person;
+        }
+    }
+
+    // estimate the rows each access path examines.
+    Room_t& rooms = meeting_data.rooms;
+    auto first_room_it = rooms.lower_bound(query.first_room);
+    auto last_room_it = no_match ? first_room_it : rooms.upper_bound(query.last_room);
+    // room numbers are unique, so the range holds at most as many rooms as numbers.
+    long num_range_rooms = no_match ? 0 : min(static_cast<long>(rooms.size()),
+            static_cast<long>(query.last_room) - query.first_room + 1);
+    long room_scan_cost = num_range_rooms * (query.time ? 1 : num_time_slots_c);
+    long participant_cost = fewest_commitments ? fewest_commitments->get_number_commitments() : LONG_MAX;
+
+    Row_counts counts;
+    if (no_match)
+    {
+        if (explain)
+        {
+            os << "Plan: none, the conditions cannot match" << endl;
+        }
+    }
+    else if (participant_cost < room_scan_cost)
+    {
+        if (explain)
+        {
+            os << "Plan: commitments of " << fewest_commitments->get_lastname()
+                << ", then filter (estimated rows: " << participant_cost << ")" << endl;
+        }
+        fewest_commitments->for_each_commitment([&os, &query, &participants, &counts](int room_number, const Meeting* meeting)
+                { filter_meeting(os, query, participants, room_number, meeting, counts); });
+    }
+    else
+    {
+        if (explain)
+        {
+            os << "Plan: scan ";
+            if (query.first_room == 1 && query.last_room == INT_MAX)
+            {
+                os << "all rooms";
+            }
+            else
+            {
+                os << "rooms " << query.first_room << ".." << query.last_room;
+            }
+            os << (query.time ? ", look up meeting by time" : ", scan meetings")
+                << ", then filter (estimated rows: " << room_scan_cost << ")" << endl;
+        }
+        for (auto room_it = first_room_it; room_it != last_room_it; ++room_it)
+        {
+            int room_number = room_it->get_room_number();
+            if (!query.time)
+            {
+                room_it->for_each_Meeting([&os, &query, &participants, &counts, room_number](const Meeting* meeting)
+                        { filter_meeting(os, query, participants, room_number, meeting, counts); });
+            }
+            else if (room_it->is_Meeting_present(query.time))
+            {
+                filter_meeting(os, query, participants, room_number, room_it->get_Meeting(query.time), counts);
+            }
+        }
+    }
+
+    if (!counts.returned)
+    {
+        os << "No matching meetings" << endl;
+    }
+    if (explain)
+    {
+        os << "Rows examined: " << counts.examined << ", returned: " << counts.returned << endl;
+    }
+}
+
+// writes the person as a row if it passes the conditions.
+static void filter_person(ostream& os, const People_query& query, const Person* person, Row_counts& counts)
+{
+    ++counts.examined;
+    int commitments = person->get_number_commitments();
+    if ((query.op == '=' && commitments != query.commitments) ||
+            (query.op == '<' && commitments >= query.commitments) ||
+            (query.op == '>' && commitments <= query.commitments))
+    {
+        return;
+    }
+    ++counts.returned;
+    os << *person << endl;
+}
+
+static void query_people(MeetingData& meeting_data, istream& is, bool explain)
+{
+    People_query query = read_people_conditions(is);
+    ostream& os = meeting_data.os;
+
+    Row_counts counts;
+    if (!query.name.empty())
+    {
+        if (explain)
+        {
+            os << "Plan: look up person by name, then filter (estimated rows: 1)" << endl;
+        }
+        if (const Person* person = meeting_data.people.find(query.name))
+        {
+            filter_person(os, query, person, counts);
+        }
+    }
+    else
+    {
+        if (explain)
+        {
+            os << "Plan: scan people, then filter (estimated rows: " << meeting_data.people.size() << ")" << endl;
+        }
+        for (const Person* person : meeting_data.people)
+        {
+            filter_person(os, query, person, counts);
+        }
+    }
+
+    if (!counts.returned)
+    {
+        os << "No matching people" << endl;
+    }
+    if (explain)
+    {
+        os << "Rows examined: " << counts.examined << ", returned: " << counts.returned << endl;
+    }
+}
+
+void cmd_query(MeetingData& meeting_data)
+{
+    // the query is the rest of the line.
+    istringstream is(read_rest_of_line(meeting_data.is));
+
+    string subject;
+    is >> subject;
+    bool explain = (subject == "explain");
+    if (explain)
+    {
+        is >> subject;
+    }
+
+    string where;
+    if (is >> where && where != "where")
+    {
+        throw Error(invalid_query_message_c);
+    }
+    if (subject == "meetings")
+    {
+        query_meetings(meeting_data, is, explain);
+    }
+    else if (subject == "people")
+    {
+        query_people(meeting_data, is, explain);
+    }
+    else
+    {
+        throw Error(invalid_query_message_c);
+    }
+}
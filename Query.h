@@ -0,0 +1,36 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "Commands.h"
+
+/* The "qu" command answers ad-hoc questions about the schedule. The rest of the
+line is a query of one of the forms
+
+    qu [explain] meetings [where condition and condition ...]
+    qu [explain] people [where condition and condition ...]
+
+where a meetings condition is one of
+
+    room = N        room in A..B        time = T
+    topic = X       participant = X     (may be given more than once)
+
+and a people condition is one of
+
+    name = X        commitments = N     commitments < N     commitments > N
+
+Meetings are listed in room and time order as "Room:N Time: T Topic: X", and
+people in last name order as pg lists them.
+
+Before running a query, a planner chooses the cheapest of the available access
+paths: for meetings, a scan of the range of the sorted rooms (looking each meeting
+up by time if the time is given) or a walk of one participant's commitments; for
+people, a lookup by name or a scan of the people list. Results are written as they
+are found. With explain, the chosen plan and its estimated cost are written first,
+and the number of rows examined and returned last.
+Errors: the query cannot be parsed, room number or time out of range.
+*/
+
+// Function that handles the "qu" command.
+void cmd_query(MeetingData& meeting_data);
+
+#endif
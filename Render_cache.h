@@ -0,0 +1,47 @@
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/* A Render_cache holds the text an object's output operator produces, together with
+the version of the object it was produced from. The owner bumps its version whenever
+it changes in a way that shows in its output; printing an unchanged object then
+just copies the cached text.
+
+Printing does not change the object's observable state, so it may happen on several
+threads at once (as the batch executor does for commands that only read); the text
+is kept in an immutable block that is replaced atomically, so concurrent printers
+see either the old or the new block. Copies of a cache share the block.
+*/
+
+class Render_cache {
+public:
+    // Write the text of the specified version of the owner to the stream,
+    // calling render to write it into a buffer first if the cached text is stale.
+    template<typename F>
+    void print(std::ostream& os, unsigned long version, F render) const
+    {
+        std::shared_ptr<const Rendered> cached = std::atomic_load(&rendered);
+        if (!cached || cached->version != version)
+        {
+            std::ostringstream text;
+            render(text);
+            cached = std::make_shared<const Rendered>(version, text.str());
+            std::atomic_store(&rendered, cached);
+        }
+        os << cached->text;
+    }
+
+private:
+    struct Rendered {
+        Rendered(unsigned long version_, const std::string& text_) : version(version_), text(text_) {}
+        const unsigned long version;
+        const std::string text;
+    };
+    mutable std::shared_ptr<const Rendered> rendered;
+};
+
+#endif
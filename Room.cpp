@@ -1,28 +1,83 @@
 #include "Room.h"
+#include "Change_feed.h"
+#include "Dated_meeting.h"
 #include "Meeting.h"
 #include "Person.h"
+#include "Slot_bitsets.h"
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <functional>
 #include <new>
 
 using namespace std;
 
-// private member function that inserts a participant
-// to its correct position in the participants vector.
-void Room::ordered_insert_meeting(Meeting* meeting)
+const char* const room_attribute_names_c[num_room_attributes_c] =
+    {"projector", "video", "whiteboard", "phone", "accessible", "kitchen"};
+
+// reads a number that follows on the same line, if one does.
+static bool read_number_on_line(ifstream& is, int& number)
 {
-    // searches for a meeting of the specified time in the vector of meetings
-    // using the lower_bound algorithm.
-    auto meeting_it = lower_bound(meetings.begin(), meetings.end(), meeting, Less_than_ptr<const Meeting*>()); 
-    meetings.insert(meeting_it, meeting);
+    while (is.peek() == ' ' || is.peek() == '\t')
+    {
+        is.get();
+    }
+    if (!isdigit(is.peek()))
+    {
+        return false;
+    }
+    is >> number;
+    return true;
+}
+
+// private member function that puts a meeting into the free
+// calendar entry for its time.
+void Room::insert_meeting(Meeting* meeting)
+{
+    int slot = time_slot(meeting->get_time());
+    assert(!calendar[slot]);
+    calendar[slot] = meeting;
+    occupied_slots.set(slot);
+    meeting_spans.insert(meeting->get_start(), meeting->get_end(), meeting);
+    unsigned int slots = span_slots(meeting->get_start(), meeting->get_end());
+    busy_slots |= slots;
+    for (int busy_slot = 0; busy_slot < num_time_slots_c; ++busy_slot)
+    {
+        if (slots & (1u << busy_slot))
+        {
+            mark_slot(busy_slot, true);
+        }
+    }
+    ++version;
+    record_room_change(room_number);
 }
 
-Room::Room(ifstream& is, People_t& people_list)
+Room::Room(ifstream& is, People_t& people_list) :
+    busy_slots(0),
+    capacity(0),
+    attributes(0),
+    version(0),
+    slot_bitsets(nullptr),
+    slot_id(0),
+    capacity_bitsets(nullptr),
+    capacity_id(0)
 {
-    int num_meetings;
+    calendar.fill(nullptr);
+    int num_meetings, num_dated_meetings = 0, attribute_bits = 0;
     is >> room_number >> num_meetings;
     file_invalid_data_check(is);
+    // the number of dated meetings, the capacity and the attributes follow on the
+    // same line if any of them are not zero.
+    if (read_number_on_line(is, num_dated_meetings) && read_number_on_line(is, capacity))
+    {
+        read_number_on_line(is, attribute_bits);
+    }
+    file_invalid_data_check(is);
+    if (attribute_bits >> num_room_attributes_c)
+    {
+        throw Error(invalid_file_data_message_c);
+    }
+    attributes = attribute_bits;
     while(num_meetings--)
     {
         Meeting* room_meeting;
@@ -34,46 +89,160 @@ Room::Room(ifstream& is, People_t& people_list)
             clear_Meetings();
             throw;
         }
-        ordered_insert_meeting(room_meeting);
+        // the file may not have two meetings at the same time.
+        if (has_Meeting_conflict(room_meeting->get_start(), room_meeting->get_end()))
+        {
+            delete room_meeting;
+            clear_Meetings();
+            throw Error(invalid_file_data_message_c);
+        }
+        insert_meeting(room_meeting);
+    }
+    while (num_dated_meetings--)
+    {
+        Dated_meeting* dated_meeting;
+        try{
+            dated_meeting = new Dated_meeting(is, people_list, room_number);
+        }
+        catch(...)
+        {
+            clear_Meetings();
+            throw;
+        }
+        if (has_Dated_meeting_conflict(*dated_meeting))
+        {
+            delete dated_meeting;
+            clear_Meetings();
+            throw Error(invalid_file_data_message_c);
+        }
+        dated_meetings.insert(dated_meeting);
+        try{
+            dated_meeting->add_participant_commitments();
+        }
+        catch(...)
+        {
+            clear_Meetings();
+            throw Error(invalid_file_data_message_c);
+        }
     }
 }
 
 void Room::add_Meeting(Meeting* m)
 {
-    if(is_Meeting_present(m->get_time()))
+    if(has_Meeting_conflict(m->get_start(), m->get_end()))
     {
         throw Error(meeting_exists_at_time_message_c);
     }
-    ordered_insert_meeting(m);
+    insert_meeting(m);
 }
 
-bool Room::is_Meeting_present(int time) const
+bool Room::has_Meeting_conflict(int start, int end, const Meeting* except) const
 {
-    Meeting probe(time);
-    return binary_search(meetings.begin(), meetings.end(), &probe, Less_than_ptr<const Meeting*>());
+    const Meeting* same_hour = calendar[start / minutes_per_slot_c];
+    if (same_hour && same_hour != except)
+    {
+        return true;
+    }
+    if (!(busy_slots & span_slots(start, end)))
+    {
+        return false;
+    }
+    return !meeting_spans.for_each_overlapping(start, end,
+            [except](const Interval_map<Meeting*>::Interval& interval){ return interval.value == except; });
 }
 
+void Room::add_Dated_meeting(Dated_meeting* m)
+{
+    if (has_Dated_meeting_conflict(*m))
+    {
+        throw Error(meeting_exists_at_time_message_c);
+    }
+    dated_meetings.insert(m);
+    record_room_change(room_number);
+}
 
-Meetings_t::iterator Room::get_Meeting_iter(int time)
+Dated_meeting* Room::get_Dated_meeting_private(int date, int time) const
 {
-    Meeting probe(time);
-    // searches for a meeting of the specified time in the vector of meetings
-    // using the lower_bound algorithm. 
-    auto meeting_it = lower_bound(meetings.begin(), meetings.end(), &probe, Less_than_ptr<const Meeting*>()); 
-    // if the iterator returned points to end or a meeting whose time is
-    // different, we throw an exception. 
-    if (meeting_it == meetings.end() || (*meeting_it)->get_time() != time)
+    Dated_meeting* meeting = dated_meetings.find(date, time);
+    if (!meeting)
     {
         throw Error(no_meeting_at_time_message_c);
-    } 
-    return meeting_it;
+    }
+    return meeting;
+}
+
+const Dated_meeting* Room::get_Dated_meeting(int date, int time) const
+{
+    return get_Dated_meeting_private(date, time);
+}
+
+Dated_meeting* Room::remove_Dated_meeting(int date, int time)
+{
+    Dated_meeting* removed_meeting = get_Dated_meeting_private(date, time);
+    dated_meetings.erase(removed_meeting);
+    record_room_change(room_number);
+    return removed_meeting;
+}
+
+Dated_meeting* Room::cancel_Dated_occurrence(int date, int time)
+{
+    Dated_meeting* meeting = get_Dated_meeting_private(date, time);
+    if (!meeting->is_repeating())
+    {
+        throw Error("That meeting does not repeat!");
+    }
+    meeting->cancel(date);
+    record_room_change(room_number);
+    // the participants no longer have the occurrence.
+    meeting->for_each_participant([](Person* person){ record_person_change(person->get_lastname()); });
+    return meeting;
+}
+
+void Room::restore_Dated_occurrence(int date, Dated_meeting* meeting)
+{
+    meeting->restore(date);
+    record_room_change(room_number);
+}
+
+void Room::add_Dated_meeting_participant(int date, int time, Person* person)
+{
+    Dated_meeting* meeting = get_Dated_meeting_private(date, time);
+    if (meeting->is_participant_present(person))
+    {
+        throw Error(participant_exists_message_c);
+    }
+    person->add_dated_commitment(meeting);
+    meeting->add_participant(person);
+    record_room_change(room_number);
+}
+
+void Room::remove_Dated_meeting_participant(int date, int time, Person* person)
+{
+    Dated_meeting* meeting = get_Dated_meeting_private(date, time);
+    meeting->remove_participant(person);
+    person->remove_dated_commitment(meeting);
+    record_room_change(room_number);
+}
+
+void Room::free_busy_slots(int start, int end)
+{
+    for (int slot = start / minutes_per_slot_c; slot * minutes_per_slot_c < end; ++slot)
+    {
+        if (!meeting_spans.overlaps(slot * minutes_per_slot_c, (slot + 1) * minutes_per_slot_c))
+        {
+            busy_slots &= ~(1u << slot);
+            mark_slot(slot, false);
+        }
+    }
 }
 
 Meeting* Room::get_Meeting_private(int time) 
 {
-    auto meeting_it = get_Meeting_iter(time);
-    assert(meeting_it != meetings.end());
-    return *meeting_it;
+    if (!is_Meeting_present(time))
+    {
+        throw Error(no_meeting_at_time_message_c);
+    }
+    return calendar[time_slot(time)];
 }
  
 const Meeting* Room::get_Meeting(int time) 
@@ -86,11 +255,14 @@ const Meeting* Room::get_Meeting(int time)
 // Remove the specified Meeting, throw exception if a Meeting at that time was not found.
 Meeting* Room::remove_Meeting(int time)
 {
-    auto meeting_it = get_Meeting_iter(time);
-    assert(meeting_it != meetings.end());
-    Meeting* removed_meeting = *meeting_it;
-    // erase the meeting to be removed from the vector of meetings.
-    meetings.erase(meeting_it);
+    Meeting* removed_meeting = get_Meeting_private(time);
+    int slot = time_slot(time);
+    calendar[slot] = nullptr;
+    occupied_slots.reset(slot);
+    meeting_spans.erase(removed_meeting->get_start());
+    free_busy_slots(removed_meeting->get_start(), removed_meeting->get_end());
+    ++version;
+    record_room_change(room_number);
     return removed_meeting; 
 }
 
@@ -98,13 +270,15 @@ void Room::add_Meeting_participant(int time, Person* person)
 {
     Meeting* meeting = get_Meeting_private(time);
     assert(meeting);
-    if(meeting->is_participant_present(person))
+    if(person->has_commitment(room_number, time))
     {
-        throw Error("This person is already a participant!");
+        throw Error(participant_exists_message_c);
     }
 
     person->add_commitment(room_number, meeting);
     meeting->add_participant(person);
+    ++version;
+    record_room_change(room_number);
 }
                                                        
 void Room::remove_Meeting_participant(int time, Person* person)
@@ -113,46 +287,153 @@ void Room::remove_Meeting_participant(int time, Person* person)
     assert(meeting);
     meeting->remove_participant(person);
     person->remove_commitment(room_number, time);
+    ++version;
+    record_room_change(room_number);
+}
+
+void Room::remove_participant_commitments()
+{
+    for_each_Meeting(bind(&Meeting::remove_participant_commitments, placeholders::_1, room_number));
+    for_each_Dated_meeting(mem_fn(&Dated_meeting::remove_participant_commitments));
 }
 
 void Room::clear_Meetings()
 {
-    // deletes each of the meetings in the vector of meetings.
-    for_each(meetings.begin(), meetings.end(), [](Meeting* m){delete m;});
-    meetings.clear();
+    // deletes each of the meetings in the calendar.
+    for_each_Meeting([](const Meeting* m){delete m;});
+    for_each_Dated_meeting([](const Dated_meeting* m){delete m;});
+    dated_meetings.clear();
+    calendar.fill(nullptr);
+    for (int slot = 0; slot < num_time_slots_c; ++slot)
+    {
+        mark_slot(slot, false);
+    }
+    occupied_slots.reset();
+    meeting_spans.clear();
+    busy_slots = 0;
+    ++version;
+    record_room_change(room_number);
+}
+
+void Room::attach_slot_bitsets(Slot_bitsets* slot_bitsets_, size_t slot_id_)
+{
+    slot_bitsets = slot_bitsets_;
+    slot_id = slot_id_;
+    for (int slot = 0; slot < num_time_slots_c; ++slot)
+    {
+        if (busy_slots & (1u << slot))
+        {
+            slot_bitsets->set(slot, slot_id);
+        }
+    }
+}
+
+void Room::attach_capacity_bitsets(Slot_bitsets* capacity_bitsets_, size_t capacity_id_)
+{
+    capacity_bitsets = capacity_bitsets_;
+    capacity_id = capacity_id_;
+    for (int slot = 0; capacity_bitsets && slot < num_time_slots_c; ++slot)
+    {
+        if (busy_slots & (1u << slot))
+        {
+            capacity_bitsets->set(slot, capacity_id);
+        }
+    }
+}
+
+void Room::mark_slot(int slot, bool busy)
+{
+    if (slot_bitsets)
+    {
+        busy ? slot_bitsets->set(slot, slot_id) : slot_bitsets->reset(slot, slot_id);
+    }
+    if (capacity_bitsets)
+    {
+        busy ? capacity_bitsets->set(slot, capacity_id) : capacity_bitsets->reset(slot, capacity_id);
+    }
 }
 
+void Room::for_each_Meeting(function<void(const Meeting*)> func) const
+{
+    for (const Meeting* meeting : calendar)
+    {
+        if (meeting)
+        {
+            func(meeting);
+        }
+    }
+}
 
-// Return true if the person is present in any of the meetings
-bool Room::is_participant_present(const Person* person_ptr) const
+void Room::for_each_Meeting_after(int time, function<bool(const Meeting*)> func) const
 {
-    // searches each meeting in the vector of meetings for a participant and returns true
-    // if any of them contains a participant.
-    return any_of(meetings.begin(), meetings.end(), 
-            bind(&Meeting::is_participant_present, placeholders::_1, person_ptr));
+    for (int slot = time ? time_slot(time) + 1 : 0; slot < num_time_slots_c; ++slot)
+    {
+        if (calendar[slot] && !func(calendar[slot]))
+        {
+            return;
+        }
+    }
 }
 
 // Write a Rooms's data to a stream in save format, with endl as specified.
 void Room::save(ostream& os) const
 {
-    os << room_number << " " << get_number_Meetings() << endl;
-    // saves each meeting in the vector of meetings.
-    for_each(meetings.begin(), meetings.end(), 
-            bind(&Meeting::save, placeholders::_1, ref(os)));
+    save_room_heading(os, room_number, get_number_Meetings(), get_number_Dated_meetings(), capacity, attributes);
+    // saves each meeting in the calendar, then the dated meetings.
+    for_each_Meeting(bind(&Meeting::save, placeholders::_1, ref(os)));
+    for_each_Dated_meeting(bind(&Dated_meeting::save, placeholders::_1, ref(os)));
 }
 
-ostream& operator<< (ostream& os, const Room& room)
+bool parse_room_attribute(const string& name, unsigned int& attributes)
 {
-    os << "--- Room " << room.room_number <<  " ---" << endl;
-    if (room.meetings.empty())
+    for (int i = 0; i < num_room_attributes_c; ++i)
     {
-        os << "No meetings are scheduled" << endl;
+        if (name == room_attribute_names_c[i])
+        {
+            attributes |= 1u << i;
+            return true;
+        }
     }
-    else
+    return false;
+}
+
+void print_room_attributes(ostream& os, unsigned int attributes)
+{
+    for (int i = 0; i < num_room_attributes_c; ++i)
     {
-        // print each meeting in the vector of meetings.
-        for_each(room.meetings.begin(), room.meetings.end(),
-                [&os](const Meeting* meeting){os << *meeting;});
+        if (attributes & (1u << i))
+        {
+            os << " " << room_attribute_names_c[i];
+        }
     }
+}
+
+void save_room_heading(ostream& os, int room_number, int num_meetings, int num_dated_meetings,
+        int capacity, unsigned int attributes)
+{
+    os << room_number << " " << num_meetings;
+    if (num_dated_meetings || capacity || attributes)
+    {
+        os << " " << num_dated_meetings << " " << capacity << " " << attributes;
+    }
+    os << endl;
+}
+
+ostream& operator<< (ostream& os, const Room& room)
+{
+    // an unchanged room is printed from its cached text.
+    room.render_cache.print(os, room.version, [&room](ostream& text)
+            {
+                print_room_heading(text, room.room_number);
+                if (!room.has_Meetings())
+                {
+                    print_no_meetings(text);
+                }
+                else
+                {
+                    // print each meeting in the calendar.
+                    room.for_each_Meeting([&text](const Meeting* meeting){text << *meeting;});
+                }
+            });
     return os;
 }
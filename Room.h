@@ -2,33 +2,55 @@
 #define ROOM_H
 
 #include "Utility.h"
+#include "Horizon.h"
+#include "Interval_map.h"
+#include "Render_cache.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <functional>
 #include <ostream>
-#include <vector>
+#include <string>
 
+class Dated_meeting;
 class Meeting;
+class Slot_bitsets;
 
-using Meetings_t = std::vector<Meeting*>;
-/* A Room object contains a room number and a list containing Meeting objects stored with
-meeting times as the key.  When created, a Room has no Meetings. When destroyed, the Meeting
-objects in a Room are automatically destroyed.
+/* A Room object contains a room number and a calendar of Meeting objects with one
+entry for each meeting time of the day, indexed by the time's slot (see time_slot),
+holding the Meeting that starts in that hour, so that a Meeting is found, added or
+removed directly, and the calendar is in time order. A Meeting may start at any
+minute and last any number of minutes, so the Room also keeps the minutes its
+Meetings take in an Interval_map, and a Meeting may be added only if it overlaps
+none of the others and no other Meeting starts in its hour. When created, a Room
+has no Meetings. When destroyed, the Meeting objects in a Room are automatically destroyed.
 
 Rooms manage the Meetings contained in them; functions are present for finding, adding,
 or removing a Meeting specified by time.  The get_Meeting function returns a reference to the
 specified Meeting, so that client code can modify the meeting - e.g. by adding a participant.
-Note that modifying the time for a meeting in the container will disorder the meeting container, 
+Note that modifying the time for a meeting in the calendar would leave it in the wrong entry,
 and so should not be attempted.
 
-In addition, a Room can be asked to search for a particular Person being a participant 
-in any of the Meetings in the Room. This makes it unnecessary for client code 
-to be able to access the Meeting container in order to search for a specific participant.
+A Room also holds Dated_meetings, on dates or repeating over a range of dates, in a
+Horizon. They are apart from the meetings of the day: they are only seen by the
+commands for dated meetings, and do not conflict with the meetings of the day.
+
+A Room has a capacity and a set of attributes, such as a projector, which the
+Room_directory changes so that it can keep its rooms ordered by capacity.
+
+A Room in a Room_directory also marks the slots it has meetings in, in the directory's
+Slot_bitsets and in those of the rooms with its attributes, whenever its calendar changes.
 
 We let the compiler supply the destructor and copy/move constructors and assignment operators.
 */ 
 
 class Room {
 public:
-    // Construct a room with the specified room number and no meetings
-    Room(int room_number_) : meetings(Meetings_t()), room_number(room_number_) {}
+    // Construct a room with the specified room number, capacity and attributes, and no meetings
+    Room(int room_number_, int capacity_ = 0, unsigned int attributes_ = 0) :
+        busy_slots(0), room_number(room_number_), capacity(capacity_), attributes(attributes_), version(0),
+        slot_bitsets(nullptr), slot_id(0), capacity_bitsets(nullptr), capacity_id(0)
+        { calendar.fill(nullptr); }
     // Construct a Room from an input file stream in save format, using the people list,
     // restoring all the Meeting information. 
     // Person list is needed to resolve references to meeting participants.
@@ -41,6 +63,12 @@ public:
     // Accessors
     int get_room_number() const
         { return room_number; }
+    // the number of people the room seats, and the bits of its attributes (see
+    // room_attribute_names_c); a room seats no one until its capacity is given.
+    int get_capacity() const
+        { return capacity; }
+    unsigned int get_attributes() const
+        { return attributes; }
                     
     // Room objects manage their own Meeting container. Meetings are objects in
     // the container. The container of Meetings is not available to clients.
@@ -48,14 +76,22 @@ public:
     // Add the Meeting, throw exception if there is already a Meeting at that time.
     // A copy of the supplied Meeting is stored in the Meeting container.
     void add_Meeting(Meeting* m);
+    // Return true if a Meeting other than the except one overlaps the minutes of the
+    // day from start up to end, or starts in the same hour as start.
+    bool has_Meeting_conflict(int start, int end, const Meeting* except = nullptr) const;
     // Return true if there is at least one meeting, false if none
     bool has_Meetings() const
-        {return !meetings.empty();}		
+        {return occupied_slots.any();}
     // Return the number of meetings in this room
     int get_number_Meetings() const
-        {return meetings.size();}		
-    // Return true if there is a Meeting at the time, false if not.
-    bool is_Meeting_present(int time) const;
+        {return static_cast<int>(occupied_slots.count());}
+    // Returns the slots the room has meetings in, with bit time_slot(t) set
+    // if there is a meeting at any time in the hour from t.
+    unsigned int get_busy_slots() const
+        { return busy_slots; }
+    // Return true if there is a Meeting starting in the hour from the time, false if not.
+    bool is_Meeting_present(int time) const
+        {return occupied_slots.test(time_slot(time));}
     // Return a const pointer to a Meeting if it is present, throw exception if not.
     const Meeting* get_Meeting(int time);
     // Remove the specified Meeting, throw exception if a Meeting at that time was not found. 
@@ -70,11 +106,58 @@ public:
     // Also removes a meeting commitment for the person.
     void remove_Meeting_participant(int time, Person* person);
 
-    // Clears and deallocates the meetings in this room.
+    // Add the Dated_meeting, throw exception if it overlaps another, or starts in
+    // the same hour as another, on a date they both occur on. The room takes ownership.
+    void add_Dated_meeting(Dated_meeting* m);
+    // Return true if a Dated_meeting other than the except one would conflict with the meeting.
+    bool has_Dated_meeting_conflict(const Dated_meeting& m, const Dated_meeting* except = nullptr) const
+        { return dated_meetings.has_conflict(m, true, except); }
+    // Return true if there is at least one Dated_meeting, false if none
+    bool has_Dated_meetings() const
+        { return !dated_meetings.empty(); }
+    // Return the number of Dated_meetings in this room, each repeating one counted once
+    int get_number_Dated_meetings() const
+        { return static_cast<int>(dated_meetings.size()); }
+    // Return the Dated_meeting occurring on the date and starting in the hour from
+    // the time, throw exception if there is none.
+    const Dated_meeting* get_Dated_meeting(int date, int time) const;
+    // Remove the Dated_meeting occurring on the date at the time, with all of its
+    // occurrences, throw exception if there is none. Returns the meeting removed.
+    Dated_meeting* remove_Dated_meeting(int date, int time);
+    // Cancel the occurrence on the date of the repeating Dated_meeting at the time,
+    // throw exception if there is none or it does not repeat. Returns the meeting,
+    // so that the occurrence can be restored.
+    Dated_meeting* cancel_Dated_occurrence(int date, int time);
+    void restore_Dated_occurrence(int date, Dated_meeting* meeting);
+
+    // Add or remove a participant of the Dated_meeting occurring on the date at
+    // the time, along with the person's commitment to it.
+    // Throw exception if the participant is already present, or is not.
+    void add_Dated_meeting_participant(int date, int time, Person* person);
+    void remove_Dated_meeting_participant(int date, int time, Person* person);
+
+    // Call the function with the date and meeting of each occurrence of the Dated_meetings
+    // from first_date to last_date, in date and time order.
+    void for_each_Dated_occurrence(int first_date, int last_date,
+            std::function<void(int date, const Dated_meeting* meeting)> func) const
+        { dated_meetings.for_each_occurrence(first_date, last_date, func); }
+
+    // Call the function with each of the Dated_meetings in this room, in the order they are saved.
+    void for_each_Dated_meeting(std::function<void(const Dated_meeting*)> func) const
+        { dated_meetings.for_each_meeting(func); }
+
+    // Removes the commitments of the participants of every meeting in this room.
+    void remove_participant_commitments();
+
+    // Clears and deallocates the meetings in this room, dated ones included.
     void clear_Meetings();
 
-    // Return true if the person is present in any of the meetings
-    bool is_participant_present(const Person* person_ptr) const;
+    // Call the function with each of the Meetings in this room, in time order.
+    void for_each_Meeting(std::function<void(const Meeting*)> func) const;
+
+    // Call the function with each of the Meetings in this room after the time,
+    // or all of them if time is zero, in time order, until it returns false.
+    void for_each_Meeting_after(int time, std::function<bool(const Meeting*)> func) const;
 
     // Write a Rooms's data to a stream in save format, with endl as specified.
     void save(std::ostream& os) const;
@@ -87,25 +170,75 @@ public:
     friend std::ostream& operator<< (std::ostream& os, const Room& room);
 
 private:
-    
-    // private member function that inserts a participant to
-    // its correct position in the participants vector.
-    void ordered_insert_meeting(Meeting* meeting);
+    // the directory gives the room its id in the directory's slot bitsets.
+    friend class Room_directory;
 
-    // returns a meeting to the iterator of the specified time.
-    Meetings_t::iterator get_Meeting_iter(int time);
+    // Mark the room's busy slots in the bitsets under the id, and keep them
+    // marked as the calendar changes: the directory's bitsets, and those of the
+    // rooms with the same attributes, or none if the bitsets are nullptr.
+    void attach_slot_bitsets(Slot_bitsets* slot_bitsets_, std::size_t slot_id_);
+    void attach_capacity_bitsets(Slot_bitsets* capacity_bitsets_, std::size_t capacity_id_);
+
+    // Mark the slot busy, or not, in the bitsets the room is attached to.
+    void mark_slot(int slot, bool busy);
+
+    // private member function that puts a meeting into the free
+    // calendar entry for its time.
+    void insert_meeting(Meeting* meeting);
 
     // Returns a non-const pointer to a meeting at a specified time.
     // This is to allow the room class to manage its meetings directly.
     Meeting* get_Meeting_private(int time);
 
-    // vector of meeting pointers to store meetings in the room.
-    Meetings_t meetings;
+    // Mark as not busy the slots of the minutes from start up to end that no meeting is in.
+    void free_busy_slots(int start, int end);
 
-    int room_number;
+    // Returns a non-const pointer to the Dated_meeting occurring on the date at the time.
+    Dated_meeting* get_Dated_meeting_private(int date, int time) const;
 
+    // the meeting starting in each time slot, or nullptr, and which slots have one.
+    std::array<Meeting*, num_time_slots_c> calendar;
+    std::bitset<num_time_slots_c> occupied_slots;
+    // the minutes of the day taken by each meeting, and the slots any meeting is in
+    Interval_map<Meeting*> meeting_spans;
+    unsigned int busy_slots;
+    // the dated meetings, which the room owns
+    Horizon dated_meetings;
+
+    int room_number;
+    int capacity;
+    unsigned int attributes;
+
+    // bumped by every change to the room or its meetings, and the output
+    // operator's text for the version it was last printed at.
+    unsigned long version;
+    Render_cache render_cache;
+
+    // the bitsets the room's busy slots are marked in, or nullptr, and its id there
+    Slot_bitsets* slot_bitsets;
+    std::size_t slot_id;
+    // the bitsets of the rooms with the same attributes, or nullptr, and the id there
+    Slot_bitsets* capacity_bitsets;
+    std::size_t capacity_id;
 };
 
+// the names of the attributes a room may have, bit i of an attribute mask naming
+// room_attribute_names_c[i].
+const int num_room_attributes_c = 6;
+extern const char* const room_attribute_names_c[num_room_attributes_c];
+
+// Set the bit of the named attribute in the mask. Returns false if there is no such attribute.
+bool parse_room_attribute(const std::string& name, unsigned int& attributes);
+
+// Write the names of the attributes in the mask, in bit order, each preceded by a space.
+void print_room_attributes(std::ostream& os, unsigned int attributes);
+
+// Write the first line of a room in save format with endl: the room number and number of
+// meetings, followed, when any of them is not zero, by the number of dated meetings, the
+// capacity and the attribute mask. Files without these therefore read the same as before.
+void save_room_heading(std::ostream& os, int room_number, int num_meetings, int num_dated_meetings,
+        int capacity, unsigned int attributes);
+
 // Print the Room data as follows:
 // The room heading with room number followed by an endl, followed by either:
 // The no-meetings message with an endl, or
@@ -0,0 +1,290 @@
+#include "Room_directory.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+// the number of table positions when the first room is added
+const size_t initial_capacity_c = 16;
+
+Room* Room_directory::find(int room_number)
+{
+    return table.empty() ? nullptr : table[find_slot(room_number)].room;
+}
+
+const Room* Room_directory::find(int room_number) const
+{
+    return table.empty() ? nullptr : table[find_slot(room_number)].room;
+}
+
+Room& Room_directory::insert(Room&& room)
+{
+    int room_number = room.get_room_number();
+    assert(!find(room_number));
+    // the room is constructed in its node, where it stays.
+    Room& added_room = rooms.emplace(room_number, move(room)).first->second;
+
+    // keep the table at most half full.
+    if (rooms.size() * 2 > table.size())
+    {
+        rebuild_table(max(table.size() * 2, initial_capacity_c));
+    }
+    table[find_slot(room_number)] = Slot{room_number, &added_room};
+
+    size_t slot_id = slot_bitsets->add_id();
+    // a new id after a room with a lower number keeps the ids in room number order.
+    if (slot_id == room_numbers_by_id.size() && (room_numbers_by_id.empty() || room_numbers_by_id.back() < room_number))
+    {
+        room_numbers_by_id.push_back(room_number);
+    }
+    else
+    {
+        room_numbers_by_id.resize(max(room_numbers_by_id.size(), slot_id + 1));
+        room_numbers_by_id[slot_id] = room_number;
+        ids_in_order.store(false, memory_order_relaxed);
+    }
+    added_room.attach_slot_bitsets(slot_bitsets.get(), slot_id);
+    add_to_group(added_room);
+    return added_room;
+}
+
+void Room_directory::erase(int room_number)
+{
+    if (table.empty() || !table[find_slot(room_number)].room)
+    {
+        return;
+    }
+    // remove the room by shifting back the entries after it in its probe
+    // sequence that would no longer be found.
+    size_t mask = table.size() - 1;
+    size_t hole = find_slot(room_number);
+    slot_bitsets->remove_id(table[hole].room->slot_id);
+    remove_from_group(*table[hole].room);
+    table[hole].room = nullptr;
+    for (size_t next = (hole + 1) & mask; table[next].room; next = (next + 1) & mask)
+    {
+        size_t home = home_slot(table[next].room_number);
+        // the entry can move if its home is not cyclically in (hole, next].
+        bool home_after_hole = (next > hole) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!home_after_hole)
+        {
+            table[hole] = table[next];
+            table[next].room = nullptr;
+            hole = next;
+        }
+    }
+    rooms.erase(room_number);
+}
+
+void Room_directory::clear()
+{
+    rooms.clear();
+    table.clear();
+    table.shrink_to_fit();
+    slot_bitsets->clear();
+    room_numbers_by_id.clear();
+    ids_in_order.store(true, memory_order_relaxed);
+    capacity_groups.clear();
+    groups_sorted.store(true, memory_order_relaxed);
+}
+
+void Room_directory::swap(Room_directory& other)
+{
+    // the nodes, and so the rooms the tables point to, change owners but not addresses.
+    rooms.swap(other.rooms);
+    table.swap(other.table);
+    slot_bitsets.swap(other.slot_bitsets);
+    room_numbers_by_id.swap(other.room_numbers_by_id);
+    bool other_ids_in_order = other.ids_in_order.load(memory_order_relaxed);
+    other.ids_in_order.store(ids_in_order.load(memory_order_relaxed), memory_order_relaxed);
+    ids_in_order.store(other_ids_in_order, memory_order_relaxed);
+    capacity_groups.swap(other.capacity_groups);
+    bool other_groups_sorted = other.groups_sorted.load(memory_order_relaxed);
+    other.groups_sorted.store(groups_sorted.load(memory_order_relaxed), memory_order_relaxed);
+    groups_sorted.store(other_groups_sorted, memory_order_relaxed);
+}
+
+vector<int> Room_directory::find_rooms_at(int time, bool busy)
+{
+    renumber_rooms();
+    vector<size_t> slot_ids = slot_bitsets->find_ids(time_slot(time), busy);
+    vector<int> room_numbers(slot_ids.size());
+    for (size_t i = 0; i < slot_ids.size(); ++i)
+    {
+        room_numbers[i] = room_numbers_by_id[slot_ids[i]];
+    }
+    return room_numbers;
+}
+
+void Room_directory::renumber_rooms()
+{
+    if (ids_in_order.load(memory_order_acquire))
+    {
+        return;
+    }
+    lock_guard<mutex> lock(renumber_mutex);
+    if (!ids_in_order.load(memory_order_relaxed))
+    {
+        slot_bitsets->clear();
+        room_numbers_by_id.clear();
+        for (auto& room_pair : rooms)
+        {
+            room_numbers_by_id.push_back(room_pair.first);
+            room_pair.second.attach_slot_bitsets(slot_bitsets.get(), slot_bitsets->add_id());
+        }
+        ids_in_order.store(true, memory_order_release);
+    }
+}
+
+const Room* Room_directory::find_room_for(int time, int num_seats, unsigned int attributes)
+{
+    sort_groups();
+    int slot = time_slot(time);
+    const Room* best_room = nullptr;
+    for (auto& group_pair : capacity_groups)
+    {
+        if ((group_pair.first & attributes) != attributes)
+        {
+            continue;
+        }
+        const vector<Room*>& group_rooms = group_pair.second.rooms;
+        auto first_it = std::lower_bound(group_rooms.begin(), group_rooms.end(), num_seats,
+            [](const Room* room, int seats) { return room->get_capacity() < seats; });
+        size_t id = group_pair.second.slot_bitsets->find_first(slot, first_it - group_rooms.begin(), false);
+        if (id == Slot_bitsets::no_id_c)
+        {
+            continue;
+        }
+        const Room* room = group_rooms[id];
+        if (!best_room || make_pair(room->get_capacity(), room->get_room_number()) <
+                make_pair(best_room->get_capacity(), best_room->get_room_number()))
+        {
+            best_room = room;
+        }
+    }
+    return best_room;
+}
+
+void Room_directory::set_room_features(Room& room, int capacity, unsigned int attributes)
+{
+    remove_from_group(room);
+    room.capacity = capacity;
+    room.attributes = attributes;
+    add_to_group(room);
+}
+
+// the order of the rooms in a capacity group
+static bool capacity_order(const Room* room1, const Room* room2)
+{
+    return make_pair(room1->get_capacity(), room1->get_room_number()) <
+        make_pair(room2->get_capacity(), room2->get_room_number());
+}
+
+void Room_directory::add_to_group(Room& room)
+{
+    Capacity_group& group = capacity_groups[room.attributes];
+    if (!group.slot_bitsets)
+    {
+        group.slot_bitsets.reset(new Slot_bitsets);
+        group.sorted = true;
+    }
+    room.attach_capacity_bitsets(nullptr, 0);
+    group.rooms.push_back(&room);
+    // a room after the last one in capacity order takes the next place.
+    size_t size = group.rooms.size();
+    if (group.sorted && (size == 1 || capacity_order(group.rooms[size - 2], &room)))
+    {
+        size_t capacity_id = group.slot_bitsets->add_id();
+        room.attach_capacity_bitsets(group.slot_bitsets.get(), capacity_id);
+        if (capacity_id == size - 1)
+        {
+            return;
+        }
+    }
+    group.sorted = false;
+    groups_sorted.store(false, memory_order_relaxed);
+}
+
+void Room_directory::remove_from_group(Room& room)
+{
+    auto group_it = capacity_groups.find(room.attributes);
+    assert(group_it != capacity_groups.end());
+    Capacity_group& group = group_it->second;
+    if (room.capacity_bitsets)
+    {
+        group.slot_bitsets->remove_id(room.capacity_id);
+        room.attach_capacity_bitsets(nullptr, 0);
+    }
+    vector<Room*>& group_rooms = group.rooms;
+    auto room_it = group.sorted ? std::lower_bound(group_rooms.begin(), group_rooms.end(), &room, capacity_order) :
+        std::find(group_rooms.begin(), group_rooms.end(), &room);
+    assert(room_it != group_rooms.end());
+    // removing the last room leaves the places of the others as they are.
+    if (room_it != group_rooms.end() - 1)
+    {
+        group.sorted = false;
+        groups_sorted.store(false, memory_order_relaxed);
+    }
+    group_rooms.erase(room_it);
+    if (group_rooms.empty())
+    {
+        capacity_groups.erase(group_it);
+    }
+}
+
+void Room_directory::sort_groups()
+{
+    if (groups_sorted.load(memory_order_acquire))
+    {
+        return;
+    }
+    lock_guard<mutex> lock(renumber_mutex);
+    if (!groups_sorted.load(memory_order_relaxed))
+    {
+        for (auto& group_pair : capacity_groups)
+        {
+            Capacity_group& group = group_pair.second;
+            if (group.sorted)
+            {
+                continue;
+            }
+            sort(group.rooms.begin(), group.rooms.end(), capacity_order);
+            group.slot_bitsets->clear();
+            for (Room* room : group.rooms)
+            {
+                room->attach_capacity_bitsets(group.slot_bitsets.get(), group.slot_bitsets->add_id());
+            }
+            group.sorted = true;
+        }
+        groups_sorted.store(true, memory_order_release);
+    }
+}
+
+size_t Room_directory::home_slot(int room_number) const
+{
+    // room numbers are often consecutive, so spread them with a multiplicative hash.
+    uint64_t bits = static_cast<uint32_t>(room_number) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(bits >> 32) & (table.size() - 1);
+}
+
+size_t Room_directory::find_slot(int room_number) const
+{
+    size_t mask = table.size() - 1;
+    size_t slot = home_slot(room_number);
+    while (table[slot].room && table[slot].room_number != room_number)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void Room_directory::rebuild_table(size_t capacity)
+{
+    table.assign(capacity, Slot{0, nullptr});
+    for (auto& room_pair : rooms)
+    {
+        table[find_slot(room_pair.first)] = Slot{room_pair.first, &room_pair.second};
+    }
+}
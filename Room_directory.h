@@ -0,0 +1,182 @@
+#ifndef ROOM_DIRECTORY_H
+#define ROOM_DIRECTORY_H
+
+#include "Room.h"
+#include "Slot_bitsets.h"
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* A Room_directory holds the rooms of a schedule, ordered by room number.
+
+Each Room lives in its own node of a balanced tree keyed by room number, so adding
+or removing a room never moves or copies any other Room; a Room's address stays
+valid until the room itself is removed. Iteration is in room number order, and
+yields Room references.
+
+Because the addresses are stable, the rooms are also indexed by an open addressing
+hash table from room number to Room, kept at most half full, so that find is a
+single probe sequence instead of a walk down the tree. Together with the Room's
+calendar, which is indexed by time slot, this takes a command from a room number
+and time to the Meeting in one hash lookup. The table only changes when rooms are
+added or removed, so commands that change the meetings of different rooms may
+still run at the same time.
+
+Each room also has an id in the directory's Slot_bitsets, where it marks the time
+slots it has meetings in, so the rooms that are free or busy at a time are found by
+scanning a bitset. Rooms added in number order get ids in number order, so the scan
+finds them in order; otherwise the first scan after the rooms were added renumbers
+them all, under a mutex so that several readers may scan at once.
+
+The rooms are also grouped by their attributes, and each group is kept in order of
+capacity, then room number, with a Slot_bitsets of its own in which a room's id is
+its place in that order. The smallest free room at a time that seats enough people
+and has the attributes asked for is then found by a binary search for the capacity
+in each group with those attributes, and a scan from there for the first room not
+busy at the time, a word of rooms at a step; the best of the groups' rooms is the
+answer. Adding a room to the end of its group keeps the order; other changes leave
+the group to be sorted again, in the same way as the ids in number order, by the
+next search.
+
+A directory is not copyable; two directories can be swapped in constant time,
+which is how ld keeps the old rooms to roll back to.
+*/
+
+class Room_directory {
+    using Map_t = std::map<int, Room>;
+
+public:
+    // iterator over the rooms of a directory, in room number order
+    template<typename Map_iterator, typename Room_type>
+    class Iterator : public std::iterator<std::bidirectional_iterator_tag, Room_type> {
+    public:
+        Iterator() {}
+        explicit Iterator(Map_iterator it_) : it(it_) {}
+        Room_type& operator* () const
+            { return it->second; }
+        Room_type* operator-> () const
+            { return &it->second; }
+        Iterator& operator++ ()
+            { ++it; return *this; }
+        Iterator operator++ (int)
+            { Iterator old = *this; ++it; return old; }
+        Iterator& operator-- ()
+            { --it; return *this; }
+        Iterator operator-- (int)
+            { Iterator old = *this; --it; return old; }
+        bool operator== (const Iterator& rhs) const
+            { return it == rhs.it; }
+        bool operator!= (const Iterator& rhs) const
+            { return it != rhs.it; }
+    private:
+        Map_iterator it;
+    };
+    using iterator = Iterator<Map_t::iterator, Room>;
+    using const_iterator = Iterator<Map_t::const_iterator, const Room>;
+
+    Room_directory() : slot_bitsets(new Slot_bitsets), ids_in_order(true), groups_sorted(true) {}
+    Room_directory(const Room_directory&) = delete;
+    Room_directory& operator= (const Room_directory&) = delete;
+
+    iterator begin()
+        { return iterator(rooms.begin()); }
+    iterator end()
+        { return iterator(rooms.end()); }
+    const_iterator begin() const
+        { return const_iterator(rooms.begin()); }
+    const_iterator end() const
+        { return const_iterator(rooms.end()); }
+
+    std::size_t size() const
+        { return rooms.size(); }
+    bool empty() const
+        { return rooms.empty(); }
+
+    // Returns the room with the number, or nullptr if there is none.
+    Room* find(int room_number);
+    const Room* find(int room_number) const;
+
+    // Returns the first room whose number is not less than (lower_bound),
+    // or is greater than (upper_bound), the room number.
+    iterator lower_bound(int room_number)
+        { return iterator(rooms.lower_bound(room_number)); }
+    const_iterator lower_bound(int room_number) const
+        { return const_iterator(rooms.lower_bound(room_number)); }
+    iterator upper_bound(int room_number)
+        { return iterator(rooms.upper_bound(room_number)); }
+    const_iterator upper_bound(int room_number) const
+        { return const_iterator(rooms.upper_bound(room_number)); }
+
+    // Returns the numbers of the rooms that have a meeting at the time (busy),
+    // or that do not, in order.
+    std::vector<int> find_rooms_at(int time, bool busy);
+
+    // Returns the room with the fewest seats, then the lowest number, that has no
+    // meeting at the time, seats at least num_seats people and has all of the
+    // attributes, or nullptr if there is none.
+    const Room* find_room_for(int time, int num_seats, unsigned int attributes);
+
+    // Give the room, which must be in the directory, the capacity and attributes.
+    void set_room_features(Room& room, int capacity, unsigned int attributes);
+
+    // Add the room, which takes over the room's meetings, and return it.
+    // There must not be a room with its number already.
+    Room& insert(Room&& room);
+
+    // Remove the room with the number, if there is one. Its meetings are not deleted.
+    void erase(int room_number);
+
+    // Remove all rooms. Their meetings are not deleted.
+    void clear();
+
+    void swap(Room_directory& other);
+
+private:
+    // a table position: the room there, or nullptr, and its number
+    struct Slot {
+        int room_number;
+        Room* room;
+    };
+
+    // Returns the table position the room number's probe sequence starts at.
+    std::size_t home_slot(int room_number) const;
+    // Returns the table position holding the room with the number, or the empty
+    // one ending its probe sequence.
+    std::size_t find_slot(int room_number) const;
+    // Rebuild the table with the specified number of positions, a power of two.
+    void rebuild_table(std::size_t capacity);
+    // Give the rooms new ids in room number order if their ids are not.
+    void renumber_rooms();
+
+    // the rooms with the same attributes, in order of capacity then room number
+    // when sorted is true, and the bitsets in which their ids are their places
+    struct Capacity_group {
+        std::vector<Room*> rooms;
+        std::unique_ptr<Slot_bitsets> slot_bitsets;
+        bool sorted;
+    };
+
+    // Add the room to the group for its attributes, or remove it from its group.
+    void add_to_group(Room& room);
+    void remove_from_group(Room& room);
+    // Sort the groups that are not in order of capacity, giving their rooms new ids.
+    void sort_groups();
+
+    Map_t rooms;
+    std::vector<Slot> table;
+    // the rooms' busy time slots, and the number of the room with each id; the
+    // bitsets are on the heap so that the rooms keep theirs when directories are swapped.
+    std::unique_ptr<Slot_bitsets> slot_bitsets;
+    std::vector<int> room_numbers_by_id;
+    std::atomic<bool> ids_in_order;
+    std::mutex renumber_mutex;
+    // the groups of rooms by attribute mask, and whether they are all sorted
+    std::map<unsigned int, Capacity_group> capacity_groups;
+    std::atomic<bool> groups_sorted;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "Shard.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+Shard::Shard(int cpu_index) :
+    stopping(false),
+    worker(&Shard::run, this)
+{
+#ifdef __linux__
+    // pin the worker to its processor; failure to pin is harmless so it is ignored.
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu_index % CPU_SETSIZE, &cpu_set);
+    pthread_setaffinity_np(worker.native_handle(), sizeof(cpu_set), &cpu_set);
+#else
+    (void)cpu_index;
+#endif
+}
+
+Shard::~Shard()
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_one();
+    worker.join();
+}
+
+void Shard::submit(Task_t task)
+{
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        tasks.push_back(move(task));
+    }
+    queue_cv.notify_one();
+}
+
+void Shard::run()
+{
+    while(true)
+    {
+        Task_t task;
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this]{ return stopping || !tasks.empty(); });
+            // only stop once the queue has been drained.
+            if (tasks.empty())
+            {
+                return;
+            }
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/* A Shard is a worker thread, pinned to one processor where the platform allows it,
+that owns some number of schedules. Work for a schedule is queued to the Shard that
+owns it and the Shard runs its tasks one at a time in the order they were submitted.
+Since a schedule's data is only ever touched by its owning Shard's thread, schedules
+need no locking; the only synchronization is on the Shard's own task queue.
+
+When destroyed, a Shard finishes the tasks already queued and then joins its thread.
+Shards cannot be copied or moved, because the thread refers to the Shard object.
+*/
+
+class Shard {
+public:
+    using Task_t = std::function<void()>;
+
+    // Start the worker thread, pinned to the processor with the given index.
+    explicit Shard(int cpu_index);
+    ~Shard();
+
+    Shard(const Shard&) = delete;
+    Shard(Shard&&) = delete;
+    Shard& operator= (const Shard&) = delete;
+    Shard& operator= (Shard&&) = delete;
+
+    // Queue a task to be run on this Shard's thread after all previously queued tasks.
+    void submit(Task_t task);
+
+private:
+    // the worker thread's loop: run queued tasks until told to stop.
+    void run();
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Task_t> tasks;
+    bool stopping;
+    // declared last so that the queue is constructed before the thread starts.
+    std::thread worker;
+};
+
+#endif
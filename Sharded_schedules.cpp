@@ -0,0 +1,330 @@
+#include "Sharded_schedules.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+// limit on the number of lines whose output has not been written yet;
+// when reached, submitting waits for the oldest one.
+const size_t max_pending_c = 65536;
+
+const char* const no_building_name_message_c = "No building name given!";
+
+// the file an sd or ld command saves or loads, or an empty string for other commands.
+static string file_of_command(const string& command)
+{
+    istringstream is(command);
+    string cmd = read_command_name(is);
+    string filename;
+    if (cmd == "sd" || cmd == "ld")
+    {
+        is >> filename;
+    }
+    return filename;
+}
+
+Sharded_schedules::Sharded_schedules(int num_shards) :
+    epoch_domain(max(num_shards, 1)),
+    next_shard(0),
+    next_reader(0)
+{
+    num_shards = max(num_shards, 1);
+    for (int i = 0; i < num_shards; ++i)
+    {
+        shards.emplace_back(new Shard(i));
+    }
+    // one reader per shard, pinned to the processors after the shards' ones.
+    for (int i = 0; i < num_shards; ++i)
+    {
+        readers.emplace_back(new Shard(num_shards + i));
+    }
+}
+
+Sharded_schedules::~Sharded_schedules()
+{
+    // output that is still pending has nowhere to go; wait for it and drop it.
+    for (auto& entry : pending)
+    {
+        entry.output.wait();
+    }
+    clear();
+}
+
+Sharded_schedules::Schedule& Sharded_schedules::get_schedule(const string& name)
+{
+    auto schedule_it = schedules.find(name);
+    if (schedule_it == schedules.end())
+    {
+        Shard* shard = shards[next_shard].get();
+        next_shard = (next_shard + 1) % shards.size();
+        schedule_it = schedules.emplace(name, unique_ptr<Schedule>(new Schedule(name, shard, epoch_domain))).first;
+    }
+    return *schedule_it->second;
+}
+
+void Sharded_schedules::submit_line(const string& line)
+{
+    istringstream is(line);
+    string first;
+    is >> first;
+    if (first.empty())
+    {
+        return;
+    }
+
+    if (first[0] == '@')
+    {
+        string name = first.substr(1);
+        if (name.empty())
+        {
+            throw Error(no_building_name_message_c);
+        }
+        string command;
+        getline(is, command);
+        istringstream command_is(command);
+        if (Published_schedule::is_read_command(read_command_name(command_is)))
+        {
+            submit_read(get_schedule(name), command);
+        }
+        else
+        {
+            submit_command(get_schedule(name), command);
+        }
+        return;
+    }
+
+    string argument;
+    is >> argument;
+    if (first == "pb")
+    {
+        ostringstream os;
+        print_list_heading(os, schedules.size(), "buildings");
+        for (const auto& schedule : schedules)
+        {
+            os << schedule.first << endl;
+        }
+        add_output(os.str());
+    }
+    else if (first == "sa" && !argument.empty())
+    {
+        save_all(argument);
+    }
+    else if (first == "la" && !argument.empty())
+    {
+        load_all(argument);
+    }
+    else
+    {
+        throw Error(invalid_command_message_c);
+    }
+}
+
+shared_ptr<promise<string>> Sharded_schedules::add_pending()
+{
+    if (pending.size() >= max_pending_c)
+    {
+        pending.front().output.wait();
+    }
+    // the promise is shared because Shard tasks must be copyable.
+    auto result = make_shared<promise<string>>();
+    pending.push_back(Pending{result->get_future(), nullptr, ""});
+    return result;
+}
+
+void Sharded_schedules::wait_for_file(const string& filename)
+{
+    if (filename.empty())
+    {
+        return;
+    }
+    for (auto& entry : pending)
+    {
+        if (entry.filename == filename)
+        {
+            entry.output.wait();
+        }
+    }
+}
+
+void Sharded_schedules::submit_command(Schedule& schedule, const string& command, const string& label)
+{
+    // an earlier command of any building may still be saving or loading the same file.
+    string filename = file_of_command(command);
+    wait_for_file(filename);
+    auto result = add_pending();
+    pending.back().filename = filename;
+    uint64_t write_number = ++schedule.submitted_writes;
+    uint64_t version = ++schedule.submitted_lines;
+    schedule.shard->submit([&schedule, command, label, result, write_number, version]
+            {
+                // versions that no outstanding or later read can see may be collected.
+                uint64_t horizon = min(schedule.snapshot_horizon.load(memory_order_acquire), write_number);
+                try{
+                    istringstream is(command);
+                    ostringstream os;
+                    os << label;
+                    MeetingData meeting_data(schedule.rooms, schedule.people, is, os, &schedule.published, &schedule.feed);
+                    Change_scope scope(schedule.feed, version);
+                    execute_command(meeting_data);
+                    schedule.published.update(command, schedule.rooms, schedule.people, write_number, horizon);
+                    result->set_value(os.str());
+                }
+                catch(...)
+                {
+                    // the schedule may be in any state; publish all of it.
+                    schedule.published.rebuild(schedule.rooms, schedule.people, write_number, horizon);
+                    result->set_exception(current_exception());
+                }
+                schedule.published_writes.store(write_number, memory_order_release);
+            });
+}
+
+void Sharded_schedules::submit_read(Schedule& schedule, const string& command)
+{
+    string filename = file_of_command(command);
+    wait_for_file(filename);
+    auto result = add_pending();
+    pending.back().filename = filename;
+    // read as of the commands submitted before this one, and keep the versions
+    // it can see from being collected until its output has been written.
+    uint64_t snapshot = schedule.submitted_writes;
+    ++schedule.submitted_lines;
+    pending.back().read_schedule = &schedule;
+    if (schedule.outstanding_reads.empty())
+    {
+        schedule.snapshot_horizon.store(snapshot, memory_order_release);
+    }
+    schedule.outstanding_reads.push_back(snapshot);
+    int reader_index = next_reader;
+    next_reader = (next_reader + 1) % readers.size();
+    Epoch_domain& domain = epoch_domain;
+    readers[reader_index]->submit([&schedule, &domain, command, result, snapshot, reader_index]
+            {
+                // wait until the snapshot has been published.
+                while (schedule.published_writes.load(memory_order_acquire) < snapshot)
+                {
+                    this_thread::yield();
+                }
+                try{
+                    ostringstream os;
+                    {
+                        Epoch_guard guard(domain, reader_index);
+                        schedule.published.execute_read(command, snapshot, os);
+                    }
+                    result->set_value(os.str());
+                }
+                catch(...)
+                {
+                    result->set_exception(current_exception());
+                }
+            });
+}
+
+void Sharded_schedules::add_output(const string& text)
+{
+    promise<string> result;
+    result.set_value(text);
+    pending.push_back(Pending{result.get_future(), nullptr, ""});
+}
+
+void Sharded_schedules::flush(ostream& os, bool wait)
+{
+    while (!pending.empty())
+    {
+        Pending& front = pending.front();
+        if (!wait && front.output.wait_for(chrono::seconds(0)) != future_status::ready)
+        {
+            return;
+        }
+        front.output.wait();
+        if (Schedule* schedule = front.read_schedule)
+        {
+            // the read is done; move the horizon up to the oldest one still outstanding.
+            front.read_schedule = nullptr;
+            schedule->outstanding_reads.pop_front();
+            schedule->snapshot_horizon.store(schedule->outstanding_reads.empty() ?
+                    UINT64_MAX : schedule->outstanding_reads.front(), memory_order_release);
+        }
+        string text = front.output.get();
+        pending.pop_front();
+        os << text;
+    }
+}
+
+void Sharded_schedules::clear()
+{
+    vector<future<void>> done;
+    for (auto& schedule_pair : schedules)
+    {
+        Schedule* schedule = schedule_pair.second.get();
+        auto cleared = make_shared<promise<void>>();
+        done.push_back(cleared->get_future());
+        uint64_t write_number = ++schedule->submitted_writes;
+        schedule->shard->submit([schedule, cleared, write_number]
+                {
+                    uint64_t horizon = min(schedule->snapshot_horizon.load(memory_order_acquire), write_number);
+                    MeetingData meeting_data(schedule->rooms, schedule->people);
+                    clear_schedule(meeting_data);
+                    schedule->published.rebuild(schedule->rooms, schedule->people, write_number, horizon);
+                    schedule->published_writes.store(write_number, memory_order_release);
+                    cleared->set_value();
+                });
+    }
+    for_each(done.begin(), done.end(), mem_fn(&future<void>::wait));
+}
+
+void Sharded_schedules::save_all(const string& prefix)
+{
+    ofstream manifest(prefix.c_str());
+    if (!manifest)
+    {
+        add_output(string(file_cannot_open_message_c) + "\n");
+        return;
+    }
+    manifest << schedules.size() << endl;
+    for (auto& schedule_pair : schedules)
+    {
+        manifest << schedule_pair.first << endl;
+    }
+    manifest.close();
+
+    // each building writes its own file on its own Shard.
+    for (auto& schedule_pair : schedules)
+    {
+        submit_command(*schedule_pair.second, "sd " + prefix + "." + schedule_pair.first,
+                schedule_pair.first + ": ");
+    }
+    add_output("Saved " + to_string(schedules.size()) + " buildings\n");
+}
+
+void Sharded_schedules::load_all(const string& prefix)
+{
+    ifstream manifest(prefix.c_str());
+    int num_schedules;
+    manifest >> num_schedules;
+    if (!manifest)
+    {
+        add_output(string(file_cannot_open_message_c) + "\n");
+        return;
+    }
+    vector<string> names;
+    while (num_schedules-- > 0)
+    {
+        string name;
+        manifest >> name;
+        if (!manifest)
+        {
+            add_output(string(invalid_file_data_message_c) + "\n");
+            return;
+        }
+        names.push_back(name);
+    }
+
+    for (const auto& name : names)
+    {
+        submit_command(get_schedule(name), "ld " + prefix + "." + name, name + ": ");
+    }
+    add_output("Loaded " + to_string(names.size()) + " buildings\n");
+}
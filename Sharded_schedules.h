@@ -0,0 +1,142 @@
+#ifndef SHARDED_SCHEDULES_H
+#define SHARDED_SCHEDULES_H
+
+#include "Commands.h"
+#include "Change_feed.h"
+#include "Epoch.h"
+#include "Published_schedule.h"
+#include "Shard.h"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <deque>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Sharded_schedules hosts many independent schedules ("buildings") in one process.
+Each building has its own rooms and people and is owned by one Shard; buildings are
+assigned to the Shards round-robin as they are created. Commands for a building are
+queued to its Shard, so commands for different buildings run in parallel while the
+commands for one building run in the order they were submitted.
+
+Input is line oriented. A line of the form
+    @building command arguments
+runs an ordinary schedule command against the named building, creating the
+building if it does not exist yet. The following lines are handled by the host itself:
+    pb          print the names of the buildings
+    sa prefix   save every building to the file "prefix.building" in parallel,
+                and the list of buildings to the file "prefix"
+    la prefix   load every building listed in the file "prefix" in parallel
+The output of each line is produced in the order the lines were submitted.
+
+The read-only commands pi, pc, pr, pm, ps, pg and sd do not go through the
+building's Shard. They are answered by a separate pool of reader threads from the
+building's Published_schedule, which the Shard brings up to date after each other
+command. A read sees the building exactly as of the commands submitted before it:
+it waits only until those have been published, takes no lock, and is not affected
+by later commands even if they run while it is reading. The versions a read can see
+are kept until its output has been written.
+
+Files are shared by all buildings, so an sd or ld command, including those of sa and
+la, is not started until every sd or ld submitted before it with the same file name
+has finished. A file is thus written and read in the order of the lines, whichever
+building and thread each command runs on.
+
+Each building has its own Change_feed, in which the commands for the building are
+numbered in the order they were submitted, reads included.
+*/
+
+class Sharded_schedules {
+public:
+    // Create the host with the specified number of Shards (at least one).
+    explicit Sharded_schedules(int num_shards);
+    // Waits for all outstanding commands and deletes all buildings.
+    ~Sharded_schedules();
+
+    Sharded_schedules(const Sharded_schedules&) = delete;
+    Sharded_schedules& operator= (const Sharded_schedules&) = delete;
+
+    // Route one line of input. Throws Error for a line the host cannot route.
+    void submit_line(const std::string& line);
+
+    // Write the output of submitted lines to the stream in submission order.
+    // If wait is true, waits for all of them; otherwise writes only those
+    // that are finished and not preceded by an unfinished one.
+    // Exceptions other than Error thrown by a command are rethrown here.
+    void flush(std::ostream& os, bool wait);
+
+    // Delete the data of every building, waiting for it to finish.
+    void clear();
+
+private:
+    struct Schedule {
+        Schedule(const std::string& name_, Shard* shard_, Epoch_domain& domain) :
+            name(name_), shard(shard_), published(domain), submitted_lines(0), submitted_writes(0),
+            published_writes(0), snapshot_horizon(UINT64_MAX) {}
+        std::string name;
+        Room_t rooms;
+        People_t people;
+        Shard* shard;
+        Published_schedule published;
+        Change_feed feed;
+        // number of commands submitted for the building, counted by the submitting thread
+        std::uint64_t submitted_lines;
+        // number of commands submitted to the Shard, counted by the submitting thread
+        std::uint64_t submitted_writes;
+        // number of those commands whose effects have been published
+        std::atomic<std::uint64_t> published_writes;
+        // snapshots of the reads whose output has not been written yet, oldest first
+        std::deque<std::uint64_t> outstanding_reads;
+        // the oldest of those snapshots, or UINT64_MAX if there are none;
+        // no snapshot before it will be read any more.
+        std::atomic<std::uint64_t> snapshot_horizon;
+    };
+
+    // The output of a submitted line, the building it read from if it was a read,
+    // and the file it saves or loads if it was an sd or ld command.
+    struct Pending {
+        std::future<std::string> output;
+        Schedule* read_schedule;
+        std::string filename;
+    };
+
+    // Returns the building with the name, creating it if it does not exist.
+    Schedule& get_schedule(const std::string& name);
+
+    // Queue the command text to the building's Shard, adding its output to the pending list.
+    // The output is prefixed with the label.
+    void submit_command(Schedule& schedule, const std::string& command, const std::string& label = "");
+
+    // Queue the lookup command text to a reader thread, adding its output to the pending list.
+    void submit_read(Schedule& schedule, const std::string& command);
+
+    // Wait until every pending line that saves or loads the file has finished;
+    // does nothing if the file name is empty.
+    void wait_for_file(const std::string& filename);
+
+    // Add an entry to the pending output and return the promise that fills it in,
+    // waiting first if too many entries are pending.
+    std::shared_ptr<std::promise<std::string>> add_pending();
+
+    // Add text produced by the host itself to the pending output.
+    void add_output(const std::string& text);
+
+    void save_all(const std::string& prefix);
+    void load_all(const std::string& prefix);
+
+    // Shards and readers are destroyed before the schedules, so no task can outlive
+    // its schedule, and the schedules before the epoch domain they use.
+    Epoch_domain epoch_domain;
+    std::map<std::string, std::unique_ptr<Schedule>> schedules;
+    std::vector<std::unique_ptr<Shard>> shards;
+    int next_shard;
+    // reader i uses slot i of the epoch domain.
+    std::vector<std::unique_ptr<Shard>> readers;
+    int next_reader;
+    std::deque<Pending> pending;
+};
+
+#endif
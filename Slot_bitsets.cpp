@@ -0,0 +1,102 @@
+#include "Slot_bitsets.h"
+#include <algorithm>
+
+using namespace std;
+
+// the number of words in each row when the first id is added
+const size_t initial_words_c = 4;
+
+size_t Slot_bitsets::add_id()
+{
+    size_t id;
+    if (!free_ids.empty())
+    {
+        id = free_ids.back();
+        free_ids.pop_back();
+    }
+    else
+    {
+        if (num_ids == num_words * bits_per_word_c)
+        {
+            // double the rows, copying the words of each into its new place.
+            size_t new_num_words = max(num_words * 2, initial_words_c);
+            unique_ptr<atomic<uint64_t>[]> new_words(new atomic<uint64_t>[(in_use_row_c + 1) * new_num_words]);
+            for (int row = 0; row <= in_use_row_c; ++row)
+            {
+                for (size_t i = 0; i < new_num_words; ++i)
+                {
+                    uint64_t value = (i < num_words) ? words[row * num_words + i].load(memory_order_relaxed) : 0;
+                    new_words[row * new_num_words + i].store(value, memory_order_relaxed);
+                }
+            }
+            words.swap(new_words);
+            num_words = new_num_words;
+        }
+        id = num_ids++;
+    }
+    word(in_use_row_c, id).fetch_or(bit(id), memory_order_relaxed);
+    return id;
+}
+
+void Slot_bitsets::remove_id(size_t id)
+{
+    for (int row = 0; row <= in_use_row_c; ++row)
+    {
+        word(row, id).fetch_and(~bit(id), memory_order_relaxed);
+    }
+    free_ids.push_back(id);
+}
+
+void Slot_bitsets::clear()
+{
+    words.reset();
+    num_words = 0;
+    num_ids = 0;
+    free_ids.clear();
+}
+
+vector<size_t> Slot_bitsets::find_ids(int slot, bool busy) const
+{
+    // the matching bits of each word, which are counted first so that the ids
+    // can be written straight into a vector of the right size.
+    vector<uint64_t> matches(num_words);
+    size_t num_matches = 0;
+    for (size_t i = 0; i < num_words; ++i)
+    {
+        uint64_t busy_bits = words[slot * num_words + i].load(memory_order_relaxed);
+        matches[i] = words[in_use_row_c * num_words + i].load(memory_order_relaxed) &
+            (busy ? busy_bits : ~busy_bits);
+        num_matches += __builtin_popcountll(matches[i]);
+    }
+    vector<size_t> ids(num_matches);
+    size_t* id = ids.data();
+    for (size_t i = 0; i < num_words; ++i)
+    {
+        // take the set bits from the lowest, clearing each one.
+        for (uint64_t bits = matches[i]; bits; bits &= bits - 1)
+        {
+            *id++ = i * bits_per_word_c + __builtin_ctzll(bits);
+        }
+    }
+    return ids;
+}
+
+size_t Slot_bitsets::find_first(int slot, size_t first_id, bool busy) const
+{
+    for (size_t i = first_id / bits_per_word_c; i < num_words; ++i)
+    {
+        uint64_t busy_bits = words[slot * num_words + i].load(memory_order_relaxed);
+        uint64_t matches = words[in_use_row_c * num_words + i].load(memory_order_relaxed) &
+            (busy ? busy_bits : ~busy_bits);
+        // in the first word, drop the bits of the ids before first_id.
+        if (i == first_id / bits_per_word_c)
+        {
+            matches &= ~(bit(first_id) - 1);
+        }
+        if (matches)
+        {
+            return i * bits_per_word_c + __builtin_ctzll(matches);
+        }
+    }
+    return no_id_c;
+}
@@ -0,0 +1,73 @@
+#ifndef SLOT_BITSETS_H
+#define SLOT_BITSETS_H
+
+#include "Utility.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* A Slot_bitsets is an inverted index from each time slot of the day to the set of
+entities (rooms or people) that are busy in it, so that "which rooms are free at 2"
+is answered by scanning a bitset a word at a time instead of visiting every room.
+
+Each entity has a small integer id, handed out by add_id and reused after remove_id,
+which is its bit position in one bitset per time slot and in a bitset of the ids in
+use. The bitsets of a slot are contiguous words, so scanning 100k rooms reads about
+1600 words. Ids are added and removed only with exclusive access to the container
+that owns the entities, but the owners of different ids may set and reset their
+bits at the same time (as the batch executor does for commands that change
+different rooms), so the words are atomic.
+*/
+
+class Slot_bitsets {
+public:
+    // returned by find_first when no id matches
+    static const std::size_t no_id_c = static_cast<std::size_t>(-1);
+
+    Slot_bitsets() : num_words(0), num_ids(0) {}
+
+    Slot_bitsets(const Slot_bitsets&) = delete;
+    Slot_bitsets& operator= (const Slot_bitsets&) = delete;
+
+    // Returns an id that is not in use, with no busy slots, and marks it in use.
+    std::size_t add_id();
+    // Clears the busy slots of the id and marks it not in use.
+    void remove_id(std::size_t id);
+    // Marks every id not in use.
+    void clear();
+
+    // Mark the id busy, or not, in the slot (see time_slot).
+    void set(int slot, std::size_t id)
+        { word(slot, id).fetch_or(bit(id), std::memory_order_relaxed); }
+    void reset(int slot, std::size_t id)
+        { word(slot, id).fetch_and(~bit(id), std::memory_order_relaxed); }
+
+    // Returns the ids in use that are busy (or, if busy is false, not busy) in
+    // the slot, in order.
+    std::vector<std::size_t> find_ids(int slot, bool busy) const;
+    // Returns the first id from first_id on that is in use and busy (or not) in
+    // the slot, or no_id_c if there is none.
+    std::size_t find_first(int slot, std::size_t first_id, bool busy) const;
+
+private:
+    static const std::size_t bits_per_word_c = 64;
+    // the row of the ids in use, after the rows of the slots
+    static const int in_use_row_c = num_time_slots_c;
+
+    static std::uint64_t bit(std::size_t id)
+        { return std::uint64_t(1) << (id % bits_per_word_c); }
+    std::atomic<std::uint64_t>& word(int row, std::size_t id) const
+        { return words[row * num_words + id / bits_per_word_c]; }
+
+    // the number of words in each row
+    std::size_t num_words;
+    // one row of num_words words for each slot, then the row of the ids in use
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+    // the ids that have been handed out, and those of them not in use
+    std::size_t num_ids;
+    std::vector<std::size_t> free_ids;
+};
+
+#endif
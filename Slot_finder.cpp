@@ -0,0 +1,236 @@
+#include "Slot_finder.h"
+#include "Meeting.h"
+#include "People_directory.h"
+#include "Person.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// string literals
+const char* const bad_count_message_c = "Count must be positive!";
+const char* const nearest_option_c = "near";
+
+// the bits of all the slots of the day
+const unsigned int all_slots_c = (1u << num_time_slots_c) - 1;
+
+// the candidate rooms of a request and the slots its people are all free in.
+struct Slot_request {
+    int first_room = 1;
+    int last_room = INT_MAX;
+    unsigned int free_slots = all_slots_c;
+};
+
+// reads the optional room range and the last names from the rest of the line.
+static Slot_request read_slot_request(MeetingData& meeting_data)
+{
+    istringstream is(read_rest_of_line(meeting_data.is));
+    Slot_request request;
+    is >> ws;
+    if (isdigit(is.peek()))
+    {
+        request.first_room = get_and_check_room_number(is);
+        request.last_room = get_and_check_room_number(is);
+        if (request.first_room > request.last_room)
+        {
+            throw Error(bad_room_range_message_c);
+        }
+    }
+    string lastname;
+    while (is >> lastname)
+    {
+        const Person* person = meeting_data.people.find(lastname);
+        if (!person)
+        {
+            throw Error(no_person_message_c);
+        }
+        request.free_slots &= ~person->get_committed_slots();
+    }
+    return request;
+}
+
+void cmd_find_slot(MeetingData& meeting_data)
+{
+    Slot_request request = read_slot_request(meeting_data);
+    int earliest_slot = num_time_slots_c;
+    int earliest_room = 0;
+    // no room can be free before the people's first free slot, so the search
+    // stops at the first room free then.
+    int first_free_slot = 0;
+    while (first_free_slot < num_time_slots_c && !(request.free_slots & (1u << first_free_slot)))
+    {
+        ++first_free_slot;
+    }
+    // a room is only taken if it is free earlier than every lower numbered room.
+    for (auto room_it = meeting_data.rooms.lower_bound(request.first_room);
+            earliest_slot > first_free_slot && room_it != meeting_data.rooms.end()
+            && room_it->get_room_number() <= request.last_room;
+            ++room_it)
+    {
+        unsigned int free_slots = request.free_slots & ~room_it->get_busy_slots();
+        for (int slot = 0; slot < earliest_slot; ++slot)
+        {
+            if (free_slots & (1u << slot))
+            {
+                earliest_slot = slot;
+                earliest_room = room_it->get_room_number();
+            }
+        }
+    }
+    if (!earliest_room)
+    {
+        meeting_data.os << "No free slot" << endl;
+        return;
+    }
+    meeting_data.os << "Earliest free slot: room " << earliest_room
+        << " at " << slot_time(earliest_slot) << endl;
+}
+
+void cmd_find_all_slots(MeetingData& meeting_data)
+{
+    Slot_request request = read_slot_request(meeting_data);
+    bool printed = false;
+    for (auto room_it = meeting_data.rooms.lower_bound(request.first_room);
+            request.free_slots && room_it != meeting_data.rooms.end()
+            && room_it->get_room_number() <= request.last_room;
+            ++room_it)
+    {
+        unsigned int free_slots = request.free_slots & ~room_it->get_busy_slots();
+        if (!free_slots)
+        {
+            continue;
+        }
+        meeting_data.os << "Room " << room_it->get_room_number() << ":";
+        for (int slot = 0; slot < num_time_slots_c; ++slot)
+        {
+            if (free_slots & (1u << slot))
+            {
+                meeting_data.os << " " << slot_time(slot);
+            }
+        }
+        meeting_data.os << endl;
+        printed = true;
+    }
+    if (!printed)
+    {
+        meeting_data.os << "No free slot" << endl;
+    }
+}
+
+bool read_nearest_option(istream& is, int& count)
+{
+    // the option may only follow on the same line.
+    while (is.peek() == ' ' || is.peek() == '\t')
+    {
+        is.get();
+    }
+    if (is.peek() != nearest_option_c[0])
+    {
+        return false;
+    }
+    istringstream option_is(read_rest_of_line(is));
+    string option;
+    option_is >> option;
+    if (option != nearest_option_c)
+    {
+        throw Error(invalid_command_message_c);
+    }
+    count = 0;
+    option_is >> ws;
+    if (option_is.eof())
+    {
+        return true;
+    }
+    option_is >> count;
+    if (!option_is || !(option_is >> ws).eof())
+    {
+        throw Error(invalid_command_message_c);
+    }
+    if (count <= 0)
+    {
+        throw Error(bad_count_message_c);
+    }
+    return true;
+}
+
+bool has_nearest_option(const string& command)
+{
+    istringstream is(command);
+    string word;
+    is >> word;
+    // the option follows the three arguments of am or the four of rm.
+    int num_arguments = (word == "am") ? 3 : (word == "rm") ? 4 : 0;
+    for (int i = 0; i < num_arguments; ++i)
+    {
+        is >> word;
+    }
+    return num_arguments && is >> word && word == nearest_option_c;
+}
+
+// Adds to the nearest the rooms, outward from the room number and the lower first on
+// a tie, that are free from start to end, until there are count of them.
+static void add_nearest_rooms(Room_t& rooms, int room_number, int start, int end,
+        const Meeting* meeting, int count, vector<Room_time>& nearest)
+{
+    int time = slot_time(start / minutes_per_slot_c);
+    vector<int> free_rooms = rooms.find_rooms_at(time, false);
+    auto above = lower_bound(free_rooms.begin(), free_rooms.end(), room_number);
+    auto below = above;
+    while (static_cast<int>(nearest.size()) < count && (below != free_rooms.begin() || above != free_rooms.end()))
+    {
+        int free_room;
+        if (above == free_rooms.end() ||
+                (below != free_rooms.begin() && room_number - *(below - 1) <= *above - room_number))
+        {
+            free_room = *--below;
+        }
+        else
+        {
+            free_room = *above++;
+        }
+        // the room is free in the hour it starts in, but a meeting past the hour
+        // may run into the next one.
+        if (!rooms.find(free_room)->has_Meeting_conflict(start, end, meeting))
+        {
+            nearest.push_back(Room_time{free_room, time});
+        }
+    }
+}
+
+vector<Room_time> find_nearest_slots(Room_t& rooms, int room_number, int time,
+        const Meeting* meeting, int count)
+{
+    int minutes_past_hour = meeting ? meeting->get_start() % minutes_per_slot_c : 0;
+    int duration = meeting ? meeting->get_duration() : minutes_per_slot_c;
+    // the slots a participant is committed in, other than the meeting's own.
+    unsigned int busy_slots = 0;
+    if (meeting)
+    {
+        meeting->for_each_participant([&busy_slots](const Person* person)
+                { busy_slots |= person->get_committed_slots(); });
+        busy_slots &= ~span_slots(meeting->get_start(), meeting->get_end());
+    }
+
+    vector<Room_time> nearest;
+    int slot = time_slot(time);
+    for (int distance = 0; distance < num_time_slots_c && static_cast<int>(nearest.size()) < count; ++distance)
+    {
+        // the earlier slot first, and the slot itself only once.
+        for (int new_slot = slot - distance; new_slot <= slot + distance; new_slot += max(2 * distance, 1))
+        {
+            int start = new_slot * minutes_per_slot_c + minutes_past_hour;
+            int end = start + duration;
+            if (new_slot < 0 || end > minutes_per_day_c || (span_slots(start, end) & busy_slots) ||
+                    (meeting && meeting->has_participant_commitment_conflict(slot_time(new_slot))))
+            {
+                continue;
+            }
+            add_nearest_rooms(rooms, room_number, start, end, meeting, count, nearest);
+        }
+    }
+    return nearest;
+}
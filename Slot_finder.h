@@ -0,0 +1,71 @@
+#ifndef SLOT_FINDER_H
+#define SLOT_FINDER_H
+
+#include "Commands.h"
+#include <string>
+#include <vector>
+
+class Meeting;
+
+/* The "fs" and "fa" commands find when a group of people can meet, and where. The
+rest of the line is
+
+    fs [first_room last_room] lastname ...
+    fa [first_room last_room] lastname ...
+
+where the optional room range (all rooms if it is not given) limits the candidate
+rooms. A (room, time) pair is free if the room has no meeting at any time in the
+hour from the time and none of the people have a commitment then. fs prints the earliest free pair, taking the
+lowest room number among the rooms free at that time; fa prints every room with a
+free pair, in room order, with its free times in time order.
+
+A person's commitments and a room's meetings are each kept as a bitmap of the time
+slots of the day, which fit in one word, so the people's availability is the
+complement of the OR of their bitmaps, and each candidate room is checked against
+it with a single AND: the cost is one hash lookup per person and one word per room.
+Errors: room number out of range, first room after last room, no person of a name.
+*/
+
+// Function that handles the "fs" command.
+void cmd_find_slot(MeetingData& meeting_data);
+
+// Function that handles the "fa" command.
+void cmd_find_all_slots(MeetingData& meeting_data);
+
+/* The "am" and "rm" commands take an optional "near" after their arguments, for when
+the room is taken at the time or, for rm, a participant is committed then:
+
+    am room time topic near [count]
+    rm room time new_room new_time near [count]
+
+With near alone, the meeting goes to the nearest (room, time) where it fits instead;
+with a count, nothing changes and up to that many of the nearest are listed. The
+nearest are those the fewest hours from the time, then the closest in room number,
+the earlier time and the lower room number first. The hours the participants are all
+free in are found from their bitmaps, and the rooms free in each of those hours from
+the directory's Slot_bitsets, outward from the room number; so only the pairs that
+are listed or taken are checked in full.
+*/
+
+// a room number and a meeting time
+struct Room_time {
+    int room_number;
+    int time;
+};
+
+// Reads the optional "near [count]", which must be on the same line. Returns false
+// if there is none, or true with a count of zero for near alone. Throws Error if
+// something else is there, or the count is not positive.
+bool read_nearest_option(std::istream& is, int& count);
+
+// Returns true if the am or rm command line has the near option.
+bool has_nearest_option(const std::string& command);
+
+// Returns up to count (room, time) pairs nearest to the room and time, nearest first,
+// where the meeting, keeping its minutes past the hour and its duration, would not
+// overlap another meeting and none of its participants are committed. The meeting
+// is nullptr for a new meeting, which fills the hour and has no participants.
+std::vector<Room_time> find_nearest_slots(Room_t& rooms, int room_number, int time,
+        const Meeting* meeting, int count);
+
+#endif
@@ -1,6 +1,14 @@
 #include "Utility.h"
+#include <cctype>
+#include <sstream>
 
+using std::endl;
 using std::ifstream;
+using std::istream;
+using std::istringstream;
+using std::ostream;
+using std::size_t;
+using std::string;
 
 void file_invalid_data_check(ifstream& is)
 {
@@ -9,3 +17,193 @@ void file_invalid_data_check(ifstream& is)
         throw Error(invalid_file_data_message_c);
     }
 }
+
+bool is_meeting_time(int time)
+{
+    /* Time is in valid range if it is from 9 to 5 in 12hr format. */
+    return (time >= 9 && time <= 12) || (time >= 1 && time <= 5);
+}
+
+// reads a time of day written as h:mm, on a quarter hour, into its minute of the day;
+// the end of the day may be read only if end is true.
+static bool read_clock_time(istream& is, bool end, int& minute)
+{
+    int time, minutes;
+    char colon;
+    if (!(is >> time >> colon >> minutes) || colon != ':' || minutes < 0 || minutes >= minutes_per_slot_c ||
+            minutes % minutes_per_quarter_c)
+    {
+        return false;
+    }
+    minute = (end && time == slot_time(num_time_slots_c)) ? minutes_per_day_c + minutes : time_minute(time) + minutes;
+    return is_meeting_time(time) || (end && minute == minutes_per_day_c);
+}
+
+bool parse_time_span(const string& text, int& start, int& duration)
+{
+    if (text.empty() || !isdigit(text[0]))
+    {
+        return false;
+    }
+    istringstream is(text);
+    if (text.find(':') == string::npos)
+    {
+        int time;
+        is >> time;
+        if (!is_meeting_time(time))
+        {
+            return false;
+        }
+        start = time_minute(time);
+        duration = minutes_per_slot_c;
+    }
+    else
+    {
+        int end;
+        char dash;
+        if (!read_clock_time(is, false, start) || !(is >> dash) || dash != '-' ||
+                !read_clock_time(is, true, end) || end <= start)
+        {
+            return false;
+        }
+        duration = end - start;
+    }
+    // nothing may follow the time.
+    char extra;
+    return !is.fail() && !(is >> extra);
+}
+
+// writes the minute of the day as h:mm.
+static void print_clock_time(ostream& os, int minute)
+{
+    int minutes = minute % minutes_per_slot_c;
+    os << slot_time(minute / minutes_per_slot_c) << ':' << (minutes < 10 ? "0" : "") << minutes;
+}
+
+void print_time_span(ostream& os, int start, int duration)
+{
+    if (start % minutes_per_slot_c == 0 && duration == minutes_per_slot_c)
+    {
+        os << slot_time(start / minutes_per_slot_c);
+        return;
+    }
+    print_clock_time(os, start);
+    os << '-';
+    print_clock_time(os, start + duration);
+}
+
+void print_commitment(ostream& os, int room_number, int start, int duration, const string& topic)
+{
+    os << "Room:" << room_number << " Time: ";
+    print_time_span(os, start, duration);
+    os << " Topic: " << topic << endl;
+}
+
+void print_no_commitments(ostream& os)
+{
+    os << "No commitments" << endl;
+}
+
+void print_meeting_heading(ostream& os, int start, int duration, const string& topic, bool has_participants)
+{
+    os << "Meeting time: ";
+    print_time_span(os, start, duration);
+    os << ", Topic: " << topic << "\nParticipants:";
+    if (has_participants)
+    {
+        os << endl;
+    }
+    else
+    {
+        os << " None" << endl;
+    }
+}
+
+void print_room_heading(ostream& os, int room_number)
+{
+    os << "--- Room " << room_number << " ---" << endl;
+}
+
+void print_no_meetings(ostream& os)
+{
+    os << "No meetings are scheduled" << endl;
+}
+
+void print_list_heading(ostream& os, size_t count, const char* items)
+{
+    os << "Information for " << count << " " << items << ":" << endl;
+}
+
+void print_empty_list(ostream& os, const char* items)
+{
+    os << "List of " << items << " is empty" << endl;
+}
+
+void print_page_cursor(ostream& os, int room_number, int time)
+{
+    os << "Next page cursor: " << room_number << "." << time << endl;
+}
+
+void print_page_cursor(ostream& os, const string& lastname)
+{
+    os << "Next page cursor: " << lastname << endl;
+}
+
+// the day number of a date of the proleptic Gregorian calendar; years are counted
+// from March so that the leap day is the last day of the year.
+static int days_from_civil(int year, int month, int day)
+{
+    year -= (month <= 2);
+    int era = year / 400;
+    int year_of_era = year - era * 400;
+    int day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+// the year, month and day of a day number, the inverse of days_from_civil.
+static void civil_from_days(int date, int& year, int& month, int& day)
+{
+    date += 719468;
+    int era = (date >= 0 ? date : date - 146096) / 146097;
+    int day_of_era = date - era * 146097;
+    int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int month_index = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    month = (month_index < 10) ? month_index + 3 : month_index - 9;
+    year = year_of_era + era * 400 + (month <= 2);
+}
+
+bool parse_date(const string& text, int& date)
+{
+    // the digits and dashes are checked first, so that signs and spaces are not read.
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+    {
+        return false;
+    }
+    for (int i : {0, 1, 2, 3, 5, 6, 8, 9})
+    {
+        if (!isdigit(text[i]))
+        {
+            return false;
+        }
+    }
+    int year = stoi(text.substr(0, 4)), month = stoi(text.substr(5, 2)), day = stoi(text.substr(8, 2));
+    if (year < 1 || month < 1 || month > 12 || day < 1)
+    {
+        return false;
+    }
+    date = days_from_civil(year, month, day);
+    // a day past the end of its month comes back as a day of the next month.
+    int check_year, check_month, check_day;
+    civil_from_days(date, check_year, check_month, check_day);
+    return check_month == month && check_day == day;
+}
+
+void print_date(ostream& os, int date)
+{
+    int year, month, day;
+    civil_from_days(date, year, month, day);
+    os << string((year < 10) + (year < 100) + (year < 1000), '0') << year << (month < 10 ? "-0" : "-") << month << (day < 10 ? "-0" : "-") << day;
+}
@@ -1,18 +1,31 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <cstddef>
 #include <fstream>
-#include <set>
+#include <ostream>
+#include <string>
 
 #define NDBUG
  
 /* Utility functions, constants, and classes used by more than one other modules */
 
 class Person;
+class People_directory;
  
 const char* const invalid_file_data_message_c = "Invalid data found in file!";
 const char* const no_meeting_at_time_message_c = "No meeting at that time!";
 const char* const meeting_exists_at_time_message_c =  "There is already a meeting at that time!";
+const char* const no_person_message_c = "No person with that name!";
+const char* const participant_exists_message_c = "This person is already a participant!";
+const char* const no_room_number_message_c = "No room with that number!";
+const char* const bad_room_range_message_c = "Room number is not in range!";
+const char* const type_not_integer_message_c = "Could not read an integer value!";
+const char* const bad_time_range_message_c = "Time is not in range!";
+const char* const invalid_command_message_c = "Unrecognized command!";
+const char* const file_cannot_open_message_c = "Could not open file!";
+const char* const no_change_message_c = "No change made to schedule";
+const char* const participant_committed_at_new_time_message_c = "A participant is already committed at the new time!";
 
  
 
@@ -32,8 +45,89 @@ struct Error {
 	const char* msg;
 };
  
-// alias for set of people.
-using People_t = std::set<Person*, Less_than_ptr<const Person*>>;
+// alias for the directory of people, which is in People_directory.h.
+using People_t = People_directory;
+
+// the number of meeting times in a day: 9 to 12 in the morning and 1 to 5 in the afternoon
+const int num_time_slots_c = 9;
+
+// Returns true if the time is one of the meeting times.
+bool is_meeting_time(int time);
+
+// Returns the position (0 to num_time_slots_c - 1) of a meeting time in the day.
+inline int time_slot(int time)
+    { return (time >= 9) ? time - 9 : time + 3; }
+
+// Returns the meeting time of a slot; the inverse of time_slot.
+inline int slot_time(int slot)
+    { return (slot < 4) ? slot + 9 : slot - 3; }
+
+// Meetings start and end at a minute of the day, counted from the start of the first
+// meeting time; a meeting given by its hour starts at the hour and lasts for the slot.
+const int minutes_per_slot_c = 60;
+const int minutes_per_day_c = num_time_slots_c * minutes_per_slot_c;
+// meetings start and end on a quarter hour.
+const int minutes_per_quarter_c = 15;
+
+// Returns the minute of the day at which a meeting time starts.
+inline int time_minute(int time)
+    { return time_slot(time) * minutes_per_slot_c; }
+
+// Returns the slots that the minutes from start up to (not including) end fall in,
+// with bit s set for slot s.
+inline unsigned int span_slots(int start, int end)
+    { return ((2u << ((end - 1) / minutes_per_slot_c)) - 1) & ~((1u << (start / minutes_per_slot_c)) - 1); }
+
+// Reads a meeting's start and duration from text that is either a meeting time,
+// such as 9 for the hour from 9, or a start and end, such as 9:30-11:00, within the
+// meeting times, on quarter hours. Returns false if the text is not one of these.
+bool parse_time_span(const std::string& text, int& start, int& duration);
+
+// Writes a meeting's start and duration as parse_time_span reads them, as the
+// meeting time alone if the meeting fills its slot.
+void print_time_span(std::ostream& os, int start, int duration);
+
+// Dates are counted in days from 1970-01-01, and a meeting on a date takes the minutes
+// from date * minutes_per_day_c onwards, so that meetings on all dates can be ordered
+// and checked for overlaps by a single number.
+
+// Reads a date written as yyyy-mm-dd, in the years 1 to 9999, into its day number.
+// Returns false if the text is not a valid date.
+bool parse_date(const std::string& text, int& date);
+
+// Writes a date as parse_date reads it.
+void print_date(std::ostream& os, int date);
+
+// The output formats of the print commands, shared by the schedule and its published
+// copy so that both print the same text.
+
+// Writes a person's commitment to a meeting as one line.
+void print_commitment(std::ostream& os, int room_number, int start, int duration, const std::string& topic);
+
+// Writes the line printed for a person without commitments.
+void print_no_commitments(std::ostream& os);
+
+// Writes a meeting's time and topic and the start of its participants, which is
+// " None" and the end of the meeting if it has none; otherwise the participants
+// follow one to a line.
+void print_meeting_heading(std::ostream& os, int start, int duration, const std::string& topic, bool has_participants);
+
+// Writes the line that starts a room's meetings.
+void print_room_heading(std::ostream& os, int room_number);
+
+// Writes the line printed for a room without meetings.
+void print_no_meetings(std::ostream& os);
+
+// Writes the line that starts a listing of count items, such as "rooms" or "people".
+void print_list_heading(std::ostream& os, std::size_t count, const char* items);
+
+// Writes the line printed for a listing without items.
+void print_empty_list(std::ostream& os, const char* items);
+
+// Writes the cursor that the next page of a listing starts after: the room and time
+// of the last row of ps, or the last name of the last row of pg.
+void print_page_cursor(std::ostream& os, int room_number, int time);
+void print_page_cursor(std::ostream& os, const std::string& lastname);
 
 // function that checks if the ifstream is in a good
 // state after reading from a file.
@@ -0,0 +1,106 @@
+#ifndef VERSION_CHAIN_H
+#define VERSION_CHAIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/* Multi-version storage for values shared with readers on other threads.
+
+A Version_chain holds the versions of one value, newest first. Each version is
+tagged with the sequence number of the change that created it, and a reader
+reading as of snapshot S sees the newest version whose tag is not after S.
+Versions are immutable once published. Only one writer thread may change a chain;
+readers may traverse it concurrently without locking.
+
+The chain owns all the versions linked into it. A version that no snapshot can see
+any more is unlinked from the tail of its chain by the writer with remove_older,
+which hands it back so that it can be reclaimed once no reader is traversing it.
+*/
+
+// The part of a version that does not depend on the type of the value.
+struct Version_node {
+    Version_node(std::uint64_t seq_, std::size_t bytes_, const Version_node* older_) :
+        seq(seq_), bytes(bytes_), older(older_) {}
+    virtual ~Version_node() {}
+
+    Version_node(const Version_node&) = delete;
+    Version_node& operator= (const Version_node&) = delete;
+
+    // sequence number of the change that created this version
+    const std::uint64_t seq;
+    // approximate memory used by this version, in bytes
+    const std::size_t bytes;
+    // the previous version, or nullptr; cleared by the writer when it is unlinked
+    mutable std::atomic<const Version_node*> older;
+};
+
+template<typename T>
+struct Version : Version_node {
+    Version(std::uint64_t seq_, T&& data_, std::size_t data_bytes, const Version_node* older_) :
+        Version_node(seq_, sizeof(Version) + data_bytes, older_), data(std::move(data_)) {}
+    const T data;
+};
+
+template<typename T>
+class Version_chain {
+public:
+    Version_chain() : head(nullptr) {}
+    // Deletes every version in the chain.
+    ~Version_chain()
+    {
+        const Version_node* node = head.load();
+        while (node)
+        {
+            const Version_node* older = node->older.load();
+            delete node;
+            node = older;
+        }
+    }
+
+    Version_chain(const Version_chain&) = delete;
+    Version_chain& operator= (const Version_chain&) = delete;
+
+    // Returns the value as of the snapshot, or nullptr if it did not exist yet.
+    const T* at(std::uint64_t snapshot) const
+    {
+        const Version_node* node = head.load();
+        while (node && node->seq > snapshot)
+        {
+            node = node->older.load();
+        }
+        return node ? &static_cast<const Version<T>*>(node)->data : nullptr;
+    }
+
+    // Returns the newest version's value, or nullptr if there is none.
+    const T* latest() const
+    {
+        const Version_node* node = head.load();
+        return node ? &static_cast<const Version<T>*>(node)->data : nullptr;
+    }
+
+    // Returns the newest version itself, or nullptr if there is none.
+    const Version_node* latest_node() const
+        { return head.load(); }
+
+    // Publish a new version of the value created by change seq,
+    // which must not be before the newest version's.
+    // Returns the new version.
+    const Version_node* publish(std::uint64_t seq, T&& data, std::size_t data_bytes)
+    {
+        const Version_node* node = new Version<T>(seq, std::move(data), data_bytes, head.load());
+        head.store(node);
+        return node;
+    }
+
+    // Unlink the versions older than the specified version of this chain,
+    // which must be the oldest ones, and return the first of them.
+    static const Version_node* remove_older(const Version_node* newer)
+        { return newer->older.exchange(nullptr); }
+
+private:
+    std::atomic<const Version_node*> head;
+};
+
+#endif
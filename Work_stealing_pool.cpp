@@ -0,0 +1,127 @@
+#include "Work_stealing_pool.h"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+// the pool and queue index of the worker running on this thread, if any.
+static thread_local Work_stealing_pool* current_pool = nullptr;
+static thread_local int current_index = 0;
+
+Work_stealing_pool::Work_stealing_pool(int num_threads) :
+    num_queued(0),
+    num_unfinished(0),
+    num_sleeping(0),
+    stopping(false),
+    next_queue(0)
+{
+    num_threads = max(num_threads, 1);
+    for (int i = 0; i < num_threads; ++i)
+    {
+        queues.emplace_back(new Worker_queue);
+    }
+    for (int i = 0; i < num_threads; ++i)
+    {
+        workers.emplace_back(&Work_stealing_pool::run, this, i);
+#ifdef __linux__
+        // pin the worker to its processor; failure to pin is harmless so it is ignored.
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(i % CPU_SETSIZE, &cpu_set);
+        pthread_setaffinity_np(workers.back().native_handle(), sizeof(cpu_set), &cpu_set);
+#endif
+    }
+}
+
+Work_stealing_pool::~Work_stealing_pool()
+{
+    wait();
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for_each(workers.begin(), workers.end(), mem_fn(&thread::join));
+}
+
+void Work_stealing_pool::submit(Task_t task)
+{
+    int index = (current_pool == this) ? current_index : next_queue++ % static_cast<int>(queues.size());
+    num_unfinished++;
+    {
+        lock_guard<mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(move(task));
+    }
+    num_queued++;
+    // a worker that went to sleep before the count went up is woken here.
+    if (num_sleeping > 0)
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        work_available.notify_one();
+    }
+}
+
+void Work_stealing_pool::wait()
+{
+    unique_lock<mutex> lock(sleep_mutex);
+    all_done.wait(lock, [this]{ return num_unfinished == 0; });
+}
+
+bool Work_stealing_pool::take_task(int index, Task_t& task)
+{
+    int num_queues = queues.size();
+    for (int i = 0; i < num_queues; ++i)
+    {
+        Worker_queue& queue = *queues[(index + i) % num_queues];
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+        // newest of our own tasks, oldest of anyone else's.
+        if (i == 0)
+        {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        num_queued--;
+        return true;
+    }
+    return false;
+}
+
+void Work_stealing_pool::run(int index)
+{
+    current_pool = this;
+    current_index = index;
+    while(true)
+    {
+        Task_t task;
+        if (take_task(index, task))
+        {
+            task();
+            if (--num_unfinished == 0)
+            {
+                lock_guard<mutex> lock(sleep_mutex);
+                all_done.notify_all();
+            }
+            continue;
+        }
+        unique_lock<mutex> lock(sleep_mutex);
+        num_sleeping++;
+        work_available.wait(lock, [this]{ return stopping || num_queued > 0; });
+        num_sleeping--;
+        if (stopping && num_queued <= 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* A Work_stealing_pool runs tasks on a fixed number of worker threads, each pinned
+to one processor where the platform allows it. Every worker has its own queue of
+tasks. A task submitted by a worker of the pool goes to the back of that worker's
+queue, where the worker itself takes it next; a worker whose queue is empty steals
+the oldest task from the front of another worker's queue. Tasks submitted from
+outside the pool are spread over the queues round-robin.
+
+Tasks may run in any order and concurrently; a task that must run after another
+has to be submitted when the other one finishes.
+*/
+
+class Work_stealing_pool {
+public:
+    using Task_t = std::function<void()>;
+
+    // Start the specified number of workers (at least one).
+    explicit Work_stealing_pool(int num_threads);
+    // Finishes the tasks already submitted and then joins the workers.
+    ~Work_stealing_pool();
+
+    Work_stealing_pool(const Work_stealing_pool&) = delete;
+    Work_stealing_pool& operator= (const Work_stealing_pool&) = delete;
+
+    // Queue a task to be run by some worker.
+    void submit(Task_t task);
+
+    // Wait until every submitted task, including those submitted by other tasks,
+    // has finished. Must not be called from a task.
+    void wait();
+
+private:
+    struct Worker_queue {
+        std::mutex mutex;
+        std::deque<Task_t> tasks;
+    };
+
+    // the worker thread's loop: run own and stolen tasks until told to stop.
+    void run(int index);
+    // Take a task from the back of the worker's own queue, or else steal one
+    // from the front of another queue. Returns false if every queue is empty.
+    bool take_task(int index, Task_t& task);
+
+    std::vector<std::unique_ptr<Worker_queue>> queues;
+    // number of tasks in the queues, and number submitted but not finished
+    std::atomic<int> num_queued;
+    std::atomic<int> num_unfinished;
+    // workers waiting for tasks sleep on work_available, and wait() on all_done
+    std::atomic<int> num_sleeping;
+    std::mutex sleep_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    bool stopping;
+    std::atomic<int> next_queue;
+    // declared last so that everything else is constructed before the threads start.
+    std::vector<std::thread> workers;
+};
+
+#endif